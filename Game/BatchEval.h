@@ -0,0 +1,127 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CHECKERS_SSE2
+#endif
+
+#include "../Models/EvalWeights.h"
+#include "../Models/Position.h"
+
+// Класс BatchEval - оценка пачки позиций за раз, для тех, кто оценивает много готовых позиций подряд
+// (проверить скорость можно Tools/EvalBench.cpp). Оценка - отношение материала бота к материалу противника,
+// как в Search::calc_score с весами Search::score_weights. Количество фигур
+// (position::pieces, 4 байта) и продвижение (position::advance, 2 слова по 16 бит) уже хранятся в позиции,
+// поэтому каждое из них читается одним 32-битным словом на позицию, а поля разбираются сдвигами и масками
+// сразу для 8 позиций (AVX2) или 4 позиций (SSE2). Без этих расширений используется обычный цикл,
+// все варианты дают в точности одинаковые оценки.
+class BatchEval
+{
+public:
+    // Набор команд, которым собрана оценка пачкой
+    static const char* kernel()
+    {
+#if defined(__AVX2__)
+        return "AVX2";
+#elif defined(CHECKERS_SSE2)
+        return "SSE2";
+#else
+        return "scalar";
+#endif
+    }
+
+    // Оценивает count позиций с точки зрения бота цвета bot_color и записывает оценки в scores.
+    // Если у противника не осталось фигур, оценка равна win_score.
+    static void evaluate(const position* boards, const size_t count, const bool bot_color, const eval_weights& w,
+        const double win_score, double* scores)
+    {
+        size_t i = 0;
+#if defined(__AVX2__)
+        // Смещения полей позиций пачки от первой позиции (в байтах) для сбора одной командой
+        const __m256i stride = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+            _mm256_set1_epi32(int(sizeof(position))));
+        const __m256i wm = _mm256_set1_epi32(w.man), wk = _mm256_set1_epi32(w.king), wa = _mm256_set1_epi32(w.advance);
+        const __m256i byte = _mm256_set1_epi32(0xFF), word = _mm256_set1_epi32(0xFFFF);
+        const __m256d win = _mm256_set1_pd(win_score);
+        for (; i + 8 <= count; i += 8)
+        {
+            const char* base = reinterpret_cast<const char*>(boards + i);
+            const __m256i p = _mm256_i32gather_epi32(reinterpret_cast<const int*>(base + offsetof(position, pieces)), stride, 1);
+            const __m256i a = _mm256_i32gather_epi32(reinterpret_cast<const int*>(base + offsetof(position, advance)), stride, 1);
+            // Материал белых (байты 0 и 2, младшее слово) и чёрных (байты 1 и 3, старшее слово)
+            const __m256i white = _mm256_add_epi32(_mm256_add_epi32(_mm256_mullo_epi32(_mm256_and_si256(p, byte), wm),
+                _mm256_mullo_epi32(_mm256_and_si256(_mm256_srli_epi32(p, 16), byte), wk)),
+                _mm256_mullo_epi32(_mm256_and_si256(a, word), wa));
+            const __m256i black = _mm256_add_epi32(_mm256_add_epi32(_mm256_mullo_epi32(_mm256_and_si256(_mm256_srli_epi32(p, 8), byte), wm),
+                _mm256_mullo_epi32(_mm256_srli_epi32(p, 24), wk)),
+                _mm256_mullo_epi32(_mm256_srli_epi32(a, 16), wa));
+            const __m256i own = bot_color ? black : white, opp = bot_color ? white : black;
+            // Деление на ноль даёт бесконечность (или NaN, если фигур нет ни у кого), а min превращает их в win_score
+            const __m256d lo = _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(own)),
+                _mm256_cvtepi32_pd(_mm256_castsi256_si128(opp)));
+            const __m256d hi = _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(own, 1)),
+                _mm256_cvtepi32_pd(_mm256_extracti128_si256(opp, 1)));
+            _mm256_storeu_pd(scores + i, _mm256_min_pd(lo, win));
+            _mm256_storeu_pd(scores + i + 4, _mm256_min_pd(hi, win));
+        }
+#elif defined(CHECKERS_SSE2)
+        // В SSE2 нет умножения 32-битных целых, но счётчики и веса меньше 2^15, поэтому хватает умножения
+        // 16-битных половин: старшие половины нулевые и дают ноль
+        const __m128i wm = _mm_set1_epi32(w.man), wk = _mm_set1_epi32(w.king), wa = _mm_set1_epi32(w.advance);
+        const __m128i byte = _mm_set1_epi32(0xFF), word = _mm_set1_epi32(0xFFFF);
+        const __m128d win = _mm_set1_pd(win_score);
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128i p = gather4(boards + i, offsetof(position, pieces));
+            const __m128i a = gather4(boards + i, offsetof(position, advance));
+            const __m128i white = _mm_add_epi32(_mm_add_epi32(_mm_mullo_epi16(_mm_and_si128(p, byte), wm),
+                _mm_mullo_epi16(_mm_and_si128(_mm_srli_epi32(p, 16), byte), wk)),
+                _mm_mullo_epi16(_mm_and_si128(a, word), wa));
+            const __m128i black = _mm_add_epi32(_mm_add_epi32(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi32(p, 8), byte), wm),
+                _mm_mullo_epi16(_mm_srli_epi32(p, 24), wk)),
+                _mm_mullo_epi16(_mm_srli_epi32(a, 16), wa));
+            const __m128i own = bot_color ? black : white, opp = bot_color ? white : black;
+            const __m128d lo = _mm_div_pd(_mm_cvtepi32_pd(own), _mm_cvtepi32_pd(opp));
+            const __m128d hi = _mm_div_pd(_mm_cvtepi32_pd(_mm_unpackhi_epi64(own, own)),
+                _mm_cvtepi32_pd(_mm_unpackhi_epi64(opp, opp)));
+            _mm_storeu_pd(scores + i, _mm_min_pd(lo, win));
+            _mm_storeu_pd(scores + i + 2, _mm_min_pd(hi, win));
+        }
+#endif
+        // Остаток пачки (или вся пачка без SIMD)
+        for (; i < count; ++i)
+        {
+            const position& pos = boards[i];
+            const int own = w.man * pos.pieces[bot_color] + w.king * pos.pieces[bot_color + 2] +
+                w.advance * pos.advance[bot_color];
+            const int opp = w.man * pos.pieces[!bot_color] + w.king * pos.pieces[!bot_color + 2] +
+                w.advance * pos.advance[!bot_color];
+            scores[i] = opp ? double(own) / double(opp) : win_score;
+        }
+    }
+
+private:
+    static_assert(sizeof(position::pieces) == 4 && sizeof(position::advance) == 4,
+        "BatchEval reads the piece counters of a position as 32-bit words");
+
+#ifdef CHECKERS_SSE2
+    // Собирает 32-битное поле со смещением offset из 4 позиций подряд. Слова собираются в регистрах:
+    // запись их в память и чтение одним 16-байтным словом стоило бы дороже всего остального расчёта.
+    static __m128i gather4(const position* boards, const size_t offset)
+    {
+        __m128i words[4];
+        for (int k = 0; k < 4; ++k)
+        {
+            int32_t word;
+            memcpy(&word, reinterpret_cast<const char*>(boards + k) + offset, sizeof(word));
+            words[k] = _mm_cvtsi32_si128(word);
+        }
+        return _mm_unpacklo_epi64(_mm_unpacklo_epi32(words[0], words[1]), _mm_unpacklo_epi32(words[2], words[3]));
+    }
+#endif
+};
@@ -3,7 +3,9 @@
 #include <fstream>
 #include <vector>
 
+#include "../Models/History.h"
 #include "../Models/Move.h"
+#include "../Models/Position.h"
 #include "../Models/Project_path.h"
 
 
@@ -13,6 +15,8 @@
 
 using namespace std;
 
+const size_t MAX_HISTORY = 256; // Сколько шагов журнала партии резервируется заранее
+
 // Класс Board управляет игровой доской, шашками и их перемещением
 class Board
 {
@@ -66,14 +70,19 @@ public:
         b_queen = IMG_LoadTexture(ren, queen_black_path.c_str());
         back = IMG_LoadTexture(ren, back_path.c_str());
         replay = IMG_LoadTexture(ren, replay_path.c_str());
-        if (!board || !w_piece || !b_piece || !w_queen || !b_queen || !back || !replay)
+        // Картинки результата тоже загружаются заранее, а не при каждой перерисовке финального экрана
+        draw_result = IMG_LoadTexture(ren, draw_path.c_str());
+        white_result = IMG_LoadTexture(ren, white_path.c_str());
+        black_result = IMG_LoadTexture(ren, black_path.c_str());
+        if (!board || !w_piece || !b_piece || !w_queen || !b_queen || !back || !replay || !draw_result ||
+            !white_result || !black_result)
         {
             print_exception("IMG_LoadTexture can't load main textures from " + textures_path);
             return 1;
         }
-        SDL_GetRendererOutputSize(ren, &W, &H);
+        reset_window_size();
         make_start_mtx(); // Устанавливаем стартовую матрицу доски
-        rerender(); // Рисуем доску
+        present(); // Рисуем доску
         return 0;
     }
 
@@ -81,8 +90,6 @@ public:
     void redraw()
     {
         game_results = -1;
-        history_mtx.clear();
-        history_beat_series.clear();
         make_start_mtx();
         clear_active();
         clear_highlight();
@@ -91,37 +98,43 @@ public:
     // Функция move_piece() выполняет перемещение шашки на новую позицию
     void move_piece(move_pos turn, const int beat_series = 0)
     {
-        if (turn.xb != -1) // Если был захват шашки, удаляем побитую шашку
+        if (mtx[turn.x2][turn.y2]) // Если конечная клетка занята - ошибка
+        {
+            throw runtime_error("final position is not empty, can't move");
+        }
+        if (!mtx[turn.x][turn.y]) // Если начальная клетка пуста - ошибка
+        {
+            throw runtime_error("begin position is empty, can't move");
+        }
+        history_record rec;
+        rec.from = int8_t(position::square(turn.x, turn.y));
+        rec.to = int8_t(position::square(turn.x2, turn.y2));
+        if (turn.xb != -1) // Если был захват шашки, запоминаем побитую шашку
         {
-            mtx[turn.xb][turn.yb] = 0;
+            rec.beaten = int8_t(position::square(turn.xb, turn.yb));
+            rec.beaten_type = mtx[turn.xb][turn.yb];
         }
-        move_piece(turn.x, turn.y, turn.x2, turn.y2, beat_series);
+        // Проверяем, станет ли обычная шашка дамкой
+        const POS_T type = mtx[turn.x][turn.y];
+        rec.promotion = (type == 1 && turn.x2 == 0) || (type == 2 && turn.x2 == 7);
+        rec.beat_series = int8_t(beat_series);
+        // Новый ход отменяет возможность повторить отменённые ходы
+        history.resize(history_len);
+        history.push_back(rec);
+        ++history_len;
+        apply(rec);
     }
 
     // Перемещение шашки на новую клетку (без учёта захвата)
     void move_piece(const POS_T i, const POS_T j, const POS_T i2, const POS_T j2, const int beat_series = 0)
     {
-        if (mtx[i2][j2]) // Если конечная клетка занята - ошибка
-        {
-            throw runtime_error("final position is not empty, can't move");
-        }
-        if (!mtx[i][j]) // Если начальная клетка пуста - ошибка
-        {
-            throw runtime_error("begin position is empty, can't move");
-        }
-        // Проверяем, стала ли обычная шашка дамкой
-        if ((mtx[i][j] == 1 && i2 == 0) || (mtx[i][j] == 2 && i2 == 7))
-            mtx[i][j] += 2;
-        mtx[i2][j2] = mtx[i][j]; // Перемещаем шашку
-        drop_piece(i, j);  // Удаляем шашку с предыдущей позиции
-        add_history(beat_series); // Сохраняем историю хода
+        move_piece(move_pos(i, j, i2, j2), beat_series);
     }
 
     // Удаляет шашку с заданных координат
     void drop_piece(const POS_T i, const POS_T j)
     {
-        mtx[i][j] = 0;
-        rerender();
+        set_cell(i, j, 0);
     }
 
     // Превращает шашку в дамку
@@ -131,13 +144,22 @@ public:
         {
             throw runtime_error("can't turn into queen in this position");
         }
-        mtx[i][j] += 2;
-        rerender();
+        set_cell(i, j, POS_T(mtx[i][j] + 2));
     }
-    vector<vector<POS_T>> get_board() const
+    const vector<vector<POS_T>>& get_board() const
     {
         return mtx;
     }
+    // Текущая позиция в упакованном виде (для Logic)
+    const position& get_position() const
+    {
+        return pos;
+    }
+    // Количество шагов в истории партии
+    size_t history_size() const
+    {
+        return history_len;
+    }
 
     // Подсвечивает клетки, доступные для хода
     void highlight_cells(vector<pair<POS_T, POS_T>> cells)
@@ -147,7 +169,7 @@ public:
             POS_T x = pos.first, y = pos.second;
             is_highlighted_[x][y] = 1;
         }
-        rerender();
+        frame_dirty = true;
     }
 
     // Очищает подсветку клеток
@@ -157,7 +179,7 @@ public:
         {
             is_highlighted_[i].assign(8, 0);
         }
-        rerender();
+        frame_dirty = true;
     }
 
     // Устанавливает активную клетку (ту, которую выбрал игрок)
@@ -165,7 +187,7 @@ public:
     {
         active_x = x;
         active_y = y;
-        rerender();
+        frame_dirty = true;
     }
 
     // Сбрасывает активную клетку
@@ -173,7 +195,7 @@ public:
     {
         active_x = -1;
         active_y = -1;
-        rerender();
+        frame_dirty = true;
     }
 
     bool is_highlighted(const POS_T x, const POS_T y)
@@ -182,15 +204,32 @@ public:
     }
 
     // Откатывает ход назад
+    // Откатывает ход назад (вместе со всей серией взятий). Отменённые шаги остаются в журнале для redo.
     void rollback()
     {
-        auto beat_series = max(1, *(history_beat_series.rbegin()));
-        while (beat_series-- && history_mtx.size() > 1)
+        if (!history_len)
+            return;
+        auto beat_series = max(1, int(history[history_len - 1].beat_series));
+        while (beat_series-- && history_len > 0)
+        {
+            undo(history[--history_len]);
+        }
+        clear_highlight();
+        clear_active();
+    }
+
+    // Повторяет последний отменённый ход (вместе со всей серией взятий)
+    void redo()
+    {
+        if (history_len == history.size())
+            return;
+        apply(history[history_len++]);
+        // Серия продолжается, пока номера взятий идут подряд
+        while (history_len < history.size() && history[history_len - 1].beat_series &&
+               history[history_len].beat_series == history[history_len - 1].beat_series + 1)
         {
-            history_mtx.pop_back();
-            history_beat_series.pop_back();
+            apply(history[history_len++]);
         }
-        mtx = *(history_mtx.rbegin());
         clear_highlight();
         clear_active();
     }
@@ -199,14 +238,41 @@ public:
     void show_final(const int res)
     {
         game_results = res;
-        rerender();
+        frame_dirty = true;
+    }
+
+    // Выводит кадр, если с прошлого кадра что-то изменилось. Изменения доски только отмечаются,
+    // поэтому несколько изменений подряд (например, ход, снятие подсветки и выделения) дают один кадр.
+    void present()
+    {
+        if (frame_dirty)
+            rerender();
+    }
+
+    // Показывает строку состояния в заголовке окна (пустая строка - только название игры)
+    void set_status(const string& status)
+    {
+        SDL_SetWindowTitle(win, status.empty() ? "Checkers" : ("Checkers - " + status).c_str());
+    }
+
+    // Требует вывести кадр заново, даже если доска не менялась (окно было перекрыто)
+    void invalidate()
+    {
+        frame_dirty = true;
     }
 
     // use if window size changed
+    // Пересчитывает размеры окна и пересоздаёт кэш доски с шашками (он же теряется при сбросе
+    // текстур-целей рендерера, поэтому функция вызывается и в этом случае)
     void reset_window_size()
     {
         SDL_GetRendererOutputSize(ren, &W, &H);
-        rerender();
+        if (scene)
+            SDL_DestroyTexture(scene);
+        // Если рендерер не поддерживает рисование в текстуру, доска рисуется напрямую в каждом кадре
+        scene = SDL_CreateTexture(ren, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, W, H);
+        scene_dirty = true;
+        frame_dirty = true;
     }
 
     // Завершает работу SDL, удаляя все текстуры и закрывая окно
@@ -219,6 +285,11 @@ public:
         SDL_DestroyTexture(b_queen);
         SDL_DestroyTexture(back);
         SDL_DestroyTexture(replay);
+        SDL_DestroyTexture(draw_result);
+        SDL_DestroyTexture(white_result);
+        SDL_DestroyTexture(black_result);
+        if (scene)
+            SDL_DestroyTexture(scene);
         SDL_DestroyRenderer(ren);
         SDL_DestroyWindow(win);
         SDL_Quit();
@@ -232,11 +303,33 @@ public:
     }
 
 private:
-    // Функция сохраняет текущее состояние доски в историю ходов
-    void add_history(const int beat_series = 0)
+    // Ставит фигуру в клетку (0 - очистить клетку), матрица и упакованная позиция меняются вместе
+    void set_cell(const POS_T i, const POS_T j, const POS_T type)
+    {
+        mtx[i][j] = type;
+        pos.set(i, j, type);
+        scene_dirty = true;
+        frame_dirty = true;
+    }
+
+    // Выполняет шаг из журнала
+    void apply(const history_record& rec)
     {
-        history_mtx.push_back(mtx);
-        history_beat_series.push_back(beat_series);
+        const POS_T i = position::row(rec.from), j = position::col(rec.from);
+        if (rec.beaten != -1)
+            set_cell(position::row(rec.beaten), position::col(rec.beaten), 0);
+        set_cell(position::row(rec.to), position::col(rec.to), POS_T(mtx[i][j] + (rec.promotion ? 2 : 0)));
+        set_cell(i, j, 0);
+    }
+
+    // Отменяет шаг из журнала
+    void undo(const history_record& rec)
+    {
+        const POS_T i = position::row(rec.to), j = position::col(rec.to);
+        set_cell(position::row(rec.from), position::col(rec.from), POS_T(mtx[i][j] - (rec.promotion ? 2 : 0)));
+        set_cell(i, j, 0);
+        if (rec.beaten != -1)
+            set_cell(position::row(rec.beaten), position::col(rec.beaten), rec.beaten_type);
     }
 
     // Функция make_start_mtx() создаёт начальное расположение шашек
@@ -254,11 +347,43 @@ private:
                     mtx[i][j] = 1; // Белые шашки
             }
         }
-        add_history(); // Добавляем стартовое состояние в историю ходов
+        pos = position::from_matrix(mtx);
+        scene_dirty = true;
+        frame_dirty = true;
+        // Журнал партии: память резервируется один раз, дальше ходы и откаты её не выделяют
+        history.reserve(MAX_HISTORY);
+        history.clear();
+        history_len = 0;
     }
 
-    // Функция выполняет перерисовку всех текстур на игровом поле
+    // Функция выполняет перерисовку кадра. Доска с шашками берётся из кэша и перерисуется только после
+    // изменения расстановки, поверх неё рисуются подсветка, выделение, кнопки и результат игры.
     void rerender()
+    {
+        if (scene)
+        {
+            if (scene_dirty)
+            {
+                SDL_SetRenderTarget(ren, scene);
+                draw_scene();
+                SDL_SetRenderTarget(ren, nullptr);
+                scene_dirty = false;
+            }
+            SDL_RenderCopy(ren, scene, NULL, NULL);
+        }
+        else
+            draw_scene();
+        draw_overlay();
+
+        SDL_RenderPresent(ren);
+        frame_dirty = false;
+        // На macOS окно обновляется только при обработке очереди событий. Очередь прокачивается без
+        // извлечения событий, чтобы не потерять клик игрока.
+        SDL_PumpEvents();
+    }
+
+    // Рисует доску и шашки
+    void draw_scene()
     {
         // Очищаем экран и рисуем игровую доску
         SDL_RenderClear(ren);
@@ -288,7 +413,11 @@ private:
                 SDL_RenderCopy(ren, piece_texture, NULL, &rect);
             }
         }
+    }
 
+    // Рисует подсветку, выделенную клетку, кнопки и результат игры
+    void draw_overlay()
+    {
         // Отрисовка подсвеченных клеток (возможные ходы)
         SDL_SetRenderDrawColor(ren, 0, 255, 0, 0);
         const double scale = 2.5;
@@ -324,27 +453,14 @@ private:
         // Отображение результата игры (если он есть)
         if (game_results != -1)
         {
-            string result_path = draw_path;
+            SDL_Texture* result_texture = draw_result;
             if (game_results == 1)
-                result_path = white_path; // Победа белых
+                result_texture = white_result; // Победа белых
             else if (game_results == 2)
-                result_path = black_path; // Победа чёрных
-            SDL_Texture* result_texture = IMG_LoadTexture(ren, result_path.c_str());
-            if (result_texture == nullptr)
-            {
-                print_exception("IMG_LoadTexture can't load game result picture from " + result_path);
-                return;
-            }
+                result_texture = black_result; // Победа чёрных
             SDL_Rect res_rect{ W / 5, H * 3 / 10, W * 3 / 5, H * 2 / 5 };
             SDL_RenderCopy(ren, result_texture, NULL, &res_rect);
-            SDL_DestroyTexture(result_texture);
         }
-
-        SDL_RenderPresent(ren);
-        // next rows for mac os
-        SDL_Delay(10);
-        SDL_Event windowEvent;
-        SDL_PollEvent(&windowEvent);
     }
     // Записывает ошибки в лог-файл
     void print_exception(const string& text) {
@@ -356,8 +472,6 @@ private:
 public:
     int W = 0;// Ширина окна
     int H = 0; // Высота окна
-    // История состояний доски
-    vector<vector<vector<POS_T>>> history_mtx;
 
 private:
     SDL_Window* win = nullptr; // Указатель на окно SDL
@@ -370,6 +484,12 @@ private:
     SDL_Texture* b_queen = nullptr;
     SDL_Texture* back = nullptr;
     SDL_Texture* replay = nullptr;
+    SDL_Texture* draw_result = nullptr;
+    SDL_Texture* white_result = nullptr;
+    SDL_Texture* black_result = nullptr;
+    SDL_Texture* scene = nullptr; // Кэш доски с шашками (nullptr - рендерер не умеет рисовать в текстуру)
+    bool scene_dirty = true; // Расстановка изменилась, кэш доски нужно перерисовать
+    bool frame_dirty = true; // Что-то изменилось, нужен новый кадр
     // Пути к файлам текстур
     const string textures_path = project_path + "Textures/";
     const string board_path = textures_path + "board.png";
@@ -391,6 +511,9 @@ private:
     // matrix of possible moves
     // 1 - white, 2 - black, 3 - white queen, 4 - black queen
     vector<vector<POS_T>> mtx = vector<vector<POS_T>>(8, vector<POS_T>(8, 0));
-    // series of beats for each move
-    vector<int> history_beat_series;
+    // packed copy of mtx for Logic
+    position pos;
+    // log of piece steps: the first history_len are played, the rest were rolled back and can be redone
+    vector<history_record> history;
+    size_t history_len = 0;
 };
\ No newline at end of file
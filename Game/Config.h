@@ -1,7 +1,9 @@
 #pragma once
 #include <fstream>
+#include <string>
 #include <nlohmann/json.hpp>
 using json = nlohmann::json;
+using namespace std;
 
 #include "../Models/Project_path.h"
 
@@ -0,0 +1,182 @@
+#pragma once
+#include <stdint.h>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <nlohmann/json.hpp>
+
+#include "../Models/Position.h"
+#include "MoveGen.h"
+
+// Класс FeatureEval - оценка позиции по признакам (метод "Features"). Каждый признак - разность значений
+// белых и чёрных, оценка - сумма признаков с весами. Веса подобраны Tools/EvalTune.cpp по позициям партий
+// самоигры так, что сумма - логарифм шансов белых на победу, и могут быть загружены из файла JSON
+// вида {"men": 0.279, "kings": 0.453, ...}. Оценка считается в листьях поиска, поэтому признаки считаются
+// сдвигами и масками позиции, а клетки перебираются только для шашек в трёх ходах от дамки.
+class FeatureEval
+{
+public:
+    static const int COUNT = 7; // Количество признаков
+    static constexpr uint32_t CENTER = (1u << 13) | (1u << 14) | (1u << 17) | (1u << 18); // Четыре центральные клетки
+    static constexpr uint32_t WHITE_RUNAWAY_ROWS = 0x0000FFF0u; // Строки 1-3: до дамки не больше трёх ходов
+    static constexpr uint32_t BLACK_RUNAWAY_ROWS = 0x0FFF0000u; // Строки 4-6
+
+    // Имя признака f в файле весов:
+    // men - шашки, kings - дамки, back_rank - шашки на своей первой строке (защита от превращения противника),
+    // center - фигуры в центре доски, mobility - ходы без взятия (у дамок - на соседние клетки), runaway - шашки
+    // в трёх ходах от дамки, перед которыми нет фигур противника, tempo - продвижение шашек (как position::advance)
+    static const char* name(const int f)
+    {
+        static const char* const names[COUNT] = { "men", "kings", "back_rank", "center", "mobility", "runaway",
+            "tempo" };
+        return names[f];
+    }
+
+    FeatureEval()
+    {
+        // Веса, обученные Tools/EvalTune.cpp, - на случай, если файла весов нет
+        static const double defaults[COUNT] = { 0.279, 0.453, 0.153, 0.0596, 0.0249, 0.0632, 0.0205 };
+        std::copy(defaults, defaults + COUNT, weights);
+    }
+
+    // Загружает веса из файла JSON. Возвращает false (и оставляет прежние веса), если файла нет
+    // или в нём нет какого-то признака.
+    bool load(const std::string& path)
+    {
+        std::ifstream fin(path);
+        if (!fin)
+            return false;
+        double res[COUNT];
+        try
+        {
+            nlohmann::json data;
+            fin >> data;
+            for (int f = 0; f < COUNT; ++f)
+            {
+                if (!data.contains(name(f)))
+                    return false;
+                res[f] = data[name(f)].get<double>();
+            }
+        }
+        catch (const std::exception&)
+        {
+            return false;
+        }
+        std::copy(res, res + COUNT, weights);
+        return true;
+    }
+
+    // Записывает веса в файл JSON, который читает load
+    bool save(const std::string& path) const
+    {
+        std::ofstream fout(path);
+        fout << "{\n";
+        for (int f = 0; f < COUNT; ++f)
+            fout << "  \"" << name(f) << "\": " << weights[f] << (f + 1 < COUNT ? ",\n" : "\n");
+        fout << "}\n";
+        return bool(fout);
+    }
+
+    // Значения признаков позиции (белые минус чёрные)
+    static void features(const position& pos, int res[COUNT])
+    {
+        const uint32_t empty = ~pos.occupied();
+        const uint32_t white_men = pos.white & ~pos.kings, black_men = pos.black & ~pos.kings;
+        res[0] = pos.pieces[0] - pos.pieces[1];
+        res[1] = pos.pieces[2] - pos.pieces[3];
+        res[2] = bit_count(white_men & MoveGen::BOTTOM_ROW) - bit_count(black_men & MoveGen::TOP_ROW);
+        res[3] = bit_count(pos.white & CENTER) - bit_count(pos.black & CENTER);
+        res[4] = steps(white_men, 0, empty) - steps(black_men, 2, empty);
+        if (pos.kings)
+            res[4] += king_steps(pos.white & pos.kings, empty) - king_steps(pos.black & pos.kings, empty);
+        res[5] = runaways(white_men & WHITE_RUNAWAY_ROWS, pos.black, false) -
+            runaways(black_men & BLACK_RUNAWAY_ROWS, pos.white, true);
+        res[6] = pos.advance[0] - pos.advance[1];
+    }
+
+    // Сумма признаков с весами: логарифм шансов белых
+    double logit(const position& pos) const
+    {
+        int f[COUNT];
+        features(pos, f);
+        double res = 0;
+        for (int i = 0; i < COUNT; ++i)
+            res += weights[i] * f[i];
+        return res;
+    }
+
+    // Оценка с точки зрения бота цвета bot_color в тех же единицах, что Search::calc_score: больше 0, равная
+    // позиция - 1, позиция противника - обратное число. Логарифм шансов e переводится в 1 + e или 1 / (1 - e):
+    // поиску нужен только порядок оценок, а деление намного дешевле экспоненты. Если у противника не осталось
+    // фигур, оценка равна win_score, если у бота - 0.
+    double score(const position& pos, const bool bot_color, const double win_score) const
+    {
+        if (!(bot_color ? pos.white : pos.black))
+            return win_score;
+        if (!(bot_color ? pos.black : pos.white))
+            return 0;
+        const double e = bot_color ? -logit(pos) : logit(pos);
+        return e >= 0 ? 1 + e : 1 / (1 - e);
+    }
+
+    double weights[COUNT]; // Веса признаков в порядке name()
+
+private:
+    // Клетки, которые должны быть свободны от фигур противника, чтобы шашка из клетки s дошла до дамки:
+    // треугольник от шашки до строки превращения (противник не успеет встать у неё на пути)
+    struct cone_tables
+    {
+        uint32_t cone[2][32];
+    };
+
+    static const cone_tables& cones()
+    {
+        static const cone_tables t = build_cones();
+        return t;
+    }
+
+    static cone_tables build_cones()
+    {
+        cone_tables t = {};
+        for (int color = 0; color < 2; ++color)
+        {
+            for (int s = 0; s < 32; ++s)
+            {
+                const int i = position::row(s), j = position::col(s);
+                for (int r = 0; r < 32; ++r)
+                {
+                    const int dist = color ? position::row(r) - i : i - position::row(r);
+                    if (dist > 0 && std::abs(position::col(r) - j) <= dist)
+                        t.cone[color][s] |= 1u << r;
+                }
+            }
+        }
+        return t;
+    }
+
+    // Количество ходов без взятия шашек men, которые ходят в направлениях dir0 и dir0 + 1
+    static int steps(const uint32_t men, const int dir0, const uint32_t empty)
+    {
+        return bit_count(MoveGen::shift(men, dir0) & empty) + bit_count(MoveGen::shift(men, dir0 + 1) & empty);
+    }
+
+    // Количество соседних свободных клеток дамок kings (дальние клетки лучей не считаются)
+    static int king_steps(const uint32_t kings, const uint32_t empty)
+    {
+        int res = 0;
+        for (int dir = 0; dir < 4; ++dir)
+            res += bit_count(MoveGen::shift(kings, dir) & empty);
+        return res;
+    }
+
+    // Количество шашек men цвета color, перед которыми нет фигур противника opp
+    static int runaways(const uint32_t men, const uint32_t opp, const bool color)
+    {
+        const cone_tables& t = cones();
+        int res = 0;
+        for (uint32_t rest = men; rest; rest &= rest - 1)
+            res += !(t.cone[color][bit_scan(rest)] & opp);
+        return res;
+    }
+};
@@ -1,6 +1,7 @@
 #pragma once
 #include <chrono>
-#include <thread>
+#include <future>
+#include <string>
 
 #include "../Models/Project_path.h"
 #include "Board.h"
@@ -11,7 +12,7 @@
 class Game
 {
 public:
-    Game() : board(config("WindowSize", "Width"), config("WindowSize", "Hight")), hand(&board), logic(&board, &config), beat_series(0), is_replay(false)
+    Game() : board(config("WindowSize", "Width"), config("WindowSize", "Hight")), hand(&board), logic(&config), beat_series(0), is_replay(false)
     {
         ofstream fout(project_path + "log.txt", ios_base::trunc);
         fout.close();
@@ -23,7 +24,7 @@ public:
         auto start = chrono::steady_clock::now(); // Засекаем время начала игры
         if (is_replay) // Если это повтор игры (режим реплея), перезагружаем логику, конфигурацию и перерисовываем доску
         {
-            logic = Logic(&board, &config); // Пересоздаём объект Logic
+            logic = Logic(&config); // Пересоздаём объект Logic
             config.reload(); // Перезагружаем настройки из файла settings.json
             board.redraw(); // Перерисовываем доску
         }
@@ -41,7 +42,7 @@ public:
         while (++turn_num < Max_turns)
         {
             beat_series = 0; // Сбрасываем счётчик серии ударов (для шашек, которые бьют несколько фигур подряд)
-            logic.find_turns(turn_num % 2); // Находим возможные ходы для текущего игрока (0 — белые, 1 — чёрные)
+            logic.find_turns(board.get_position(), turn_num % 2); // Находим возможные ходы для текущего игрока (0 — белые, 1 — чёрные)
             if (logic.turns.empty()) // Если ходов нет, игра завершается
                 break;
             // Устанавливаем глубину поиска для бота в зависимости от уровня сложности
@@ -49,7 +50,13 @@ public:
             // Если текущий игрок — человек (не бот), обрабатываем его ход
             if (!config("Bot", string("Is") + string((turn_num % 2) ? "Black" : "White") + string("Bot")))
             {
+                // Пока человек думает, бот-соперник ищет ответы на его возможные ходы
+                const string opponent = (turn_num % 2) ? "White" : "Black";
+                if (config("Bot", "Ponder") && config("Bot", "Is" + opponent + "Bot"))
+                    logic.start_ponder(board.get_position(), turn_num % 2, config("Bot", opponent + "BotLevel"));
                 auto resp = player_turn(turn_num % 2); // Обрабатываем ход игрока
+                if (resp != Response::OK) // Позиция меняется не ходом, готовые ответы бота больше не нужны
+                    logic.stop_ponder();
                 if (resp == Response::QUIT) // Если игрок решил выйти
                 {
                     is_quit = true;
@@ -64,7 +71,7 @@ public:
                 {
                     // Отменяем ход, если это возможно
                     if (config("Bot", string("Is") + string((1 - turn_num % 2) ? "Black" : "White") + string("Bot")) &&
-                        !beat_series && board.history_mtx.size() > 2)
+                        !beat_series && board.history_size() > 1)
                     {
                         board.rollback(); // Откатываем ход
                         --turn_num;  // Уменьшаем счётчик ходов
@@ -78,8 +85,22 @@ public:
                 }
             }
             else
-                bot_turn(turn_num % 2);  // Если текущий игрок — бот, обрабатываем его ход
+            {
+                auto resp = bot_turn(turn_num % 2); // Если текущий игрок — бот, обрабатываем его ход
+                if (resp == Response::QUIT)
+                {
+                    is_quit = true;
+                    break;
+                }
+                else if (resp == Response::REPLAY)
+                {
+                    is_replay = true;
+                    break;
+                }
+            }
         }
+        // Партия могла закончиться ходом человека, пока бот размышлял над ответом: размышление больше не нужно
+        logic.stop_ponder();
         auto end = chrono::steady_clock::now();  // Засекаем время окончания игры
         ofstream fout(project_path + "log.txt", ios_base::app); // Открываем файл логов для записи
         fout << "Game time: " << (int)chrono::duration<double, milli>(end - start).count() << " millisec\n";  // Записываем время игры
@@ -115,17 +136,40 @@ public:
 private:
     // Функция bot_turn() выполняет ход бота в зависимости от текущего состояния игры.
    // color - цвет бота (0 — белые, 1 — чёрные).
-    void bot_turn(const bool color)
+    // Поиск идёт в отдельном потоке, а окно тем временем обрабатывает события: показывает ход поиска
+    // в заголовке, по клику на доску прерывает поиск (бот играет лучший найденный ход), по QUIT и REPLAY
+    // отменяет его. Возвращает QUIT или REPLAY, если игрок решил выйти или переиграть, иначе OK.
+    Response bot_turn(const bool color)
     {
         auto start = chrono::steady_clock::now(); // Засекаем время начала хода бота.
+        board.present(); // Показываем последний ход соперника до начала поиска
 
-        auto delay_ms = config("Bot", "BotDelayMS"); // Получаем задержку перед ходом бота из конфигурации.
-        // Создаём новый поток, который выполняет задержку перед ходом бота.
-        thread th(SDL_Delay, delay_ms);
+        const int delay_ms = config("Bot", "BotDelayMS"); // Минимальное время хода бота из конфигурации.
         // Находим лучший ход для бота с использованием алгоритма минимакса.
-        auto turns = logic.find_best_turns(color);
-        // Дожидаемся завершения задержки.
-        th.join();
+        auto search = logic.find_best_turns_async(board.get_position(), color);
+        Response resp = Response::OK;
+        while (search.wait_for(chrono::milliseconds(0)) != future_status::ready)
+        {
+            const auto event = hand.poll(50);
+            if (get<0>(event) == Response::QUIT || get<0>(event) == Response::REPLAY)
+            {
+                resp = get<0>(event);
+                logic.cancel_search();
+            }
+            else if (get<0>(event) == Response::CELL) // Игрок не хочет ждать
+                logic.cancel_search();
+            const search_stats progress = logic.progress();
+            board.set_status("thinking: depth " + to_string(progress.depth) + ", " + to_string(progress.nodes) +
+                " nodes");
+        }
+        auto turns = search.get();
+        board.set_status("");
+        if (resp != Response::OK)
+            return resp;
+        // Ход показывается не раньше, чем через BotDelayMS после начала хода
+        resp = wait_until(start + chrono::milliseconds(delay_ms));
+        if (resp != Response::OK)
+            return resp;
         // Флаг для первого хода в серии.
         bool is_first = true;
         // Выполняем найденный ход (или серию ходов, если возможны дополнительные удары).
@@ -133,13 +177,17 @@ private:
         {
             if (!is_first)
             {
-                SDL_Delay(delay_ms); // Добавляем задержку перед каждым следующим ходом.
+                // Добавляем задержку перед каждым следующим ходом.
+                resp = wait_until(chrono::steady_clock::now() + chrono::milliseconds(delay_ms));
+                if (resp != Response::OK)
+                    return resp;
             }
             is_first = false;
             // Если бот выполняет захват шашки, увеличиваем счётчик серии ударов.
             beat_series += (turn.xb != -1);
             // Выполняем ход на игровой доске
             board.move_piece(turn, beat_series);
+            board.present();
         }
 
         auto end = chrono::steady_clock::now(); // Засекаем время завершения хода.
@@ -147,6 +195,21 @@ private:
         ofstream fout(project_path + "log.txt", ios_base::app);
         fout << "Bot turn time: " << (int)chrono::duration<double, milli>(end - start).count() << " millisec\n";
         fout.close();
+        return Response::OK;
+    }
+
+    // Обрабатывает события окна до момента time. Возвращает QUIT или REPLAY, если игрок решил выйти
+    // или переиграть, иначе OK.
+    Response wait_until(const chrono::steady_clock::time_point time)
+    {
+        for (auto now = chrono::steady_clock::now(); now < time; now = chrono::steady_clock::now())
+        {
+            const int ms = int(chrono::duration_cast<chrono::milliseconds>(time - now).count());
+            const Response resp = get<0>(hand.poll(max(ms, 1)));
+            if (resp == Response::QUIT || resp == Response::REPLAY)
+                return resp;
+        }
+        return Response::OK;
     }
 
     // Функция player_turn() обрабатывает ход игрока (человека).
@@ -235,7 +298,7 @@ private:
         beat_series = 1;
         while (true)
         {
-            logic.find_turns(pos.x2, pos.y2);
+            logic.find_turns(board.get_position(), pos.x2, pos.y2);
             if (!logic.have_beats)
                 break;
             // Подсвечиваем возможные следующие шаги
@@ -18,54 +18,13 @@ public:
     // Метод get_cell() ожидает, пока игрок кликнет на игровое пол и возвращает результат в виде кортежа: {ответ системы, координаты x и y}
     tuple<Response, POS_T, POS_T> get_cell() const
     {
-        SDL_Event windowEvent;
         Response resp = Response::OK; // Стандартный ответ (если клик некорректен)
-        int x = -1, y = -1; // Координаты клика в пикселях
         int xc = -1, yc = -1; // Координаты клика в логической системе координат (ячейки доски)
-        while (true)
+        while (resp == Response::OK) // Ждём, пока не получим корректный ответ
         {
-            if (SDL_PollEvent(&windowEvent)) // Проверяем события в очереди SDL
-            {
-                switch (windowEvent.type)
-                {
-                case SDL_QUIT:
-                    resp = Response::QUIT; // Игрок закрыл окно, завершаем игру
-                    break;
-                case SDL_MOUSEBUTTONDOWN: // Игрок кликнул мышью
-                    x = windowEvent.motion.x; // Получаем координаты клика по X
-                    y = windowEvent.motion.y; // Получаем координаты клика по Y
-                    // Преобразуем координаты из пикселей в систему координат доски
-                    xc = int(y / (board->H / 10) - 1);
-                    yc = int(x / (board->W / 10) - 1);
-                    // Если клик был за пределами игрового поля
-                    if (xc == -1 && yc == -1 && board->history_mtx.size() > 1)
-                    {
-                        resp = Response::BACK; // Игрок хочет отменить ход
-                    }
-                    else if (xc == -1 && yc == 8)
-                    {
-                        resp = Response::REPLAY; // Игрок хочет переиграть
-                    }
-                    else if (xc >= 0 && xc < 8 && yc >= 0 && yc < 8)
-                    {
-                        resp = Response::CELL; // Игрок выбрал клетку на доске
-                    }
-                    else
-                    {
-                        xc = -1;
-                        yc = -1; // Недопустимый клик, игнорируем его
-                    }
-                    break;
-                case SDL_WINDOWEVENT:
-                    if (windowEvent.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
-                    {
-                        board->reset_window_size(); // Если размер окна изменился, пересчитываем размеры доски
-                        break;
-                    }
-                }
-                if (resp != Response::OK)  // Если получен корректный ответ, выходим из цикла
-                    break;
-            }
+            resp = next_event(xc, yc);
+            if (resp == Response::BACK && board->history_size() == 0) // Отменять нечего
+                resp = Response::OK;
         }
         return { resp, xc, yc }; // Возвращаем результат ввода пользователя
     }
@@ -74,35 +33,74 @@ public:
    // Возвращает один из возможных ответов Response (QUIT, REPLAY)
     Response wait() const
     {
-        SDL_Event windowEvent;
-        Response resp = Response::OK; // Стандартный ответ
+        int xc = -1, yc = -1;
         while (true)
         {
-            if (SDL_PollEvent(&windowEvent))  // Проверяем события в очереди SDL
+            const Response resp = next_event(xc, yc);
+            if (resp == Response::QUIT || resp == Response::REPLAY) // Если есть действие игрока, завершаем ожидание
+                return resp;
+        }
+    }
+
+    // Метод poll() ждёт события не дольше timeout_ms миллисекунд (пока, например, думает бот).
+    // Возвращает Response::OK, если за это время игрок ничего не сделал.
+    tuple<Response, POS_T, POS_T> poll(const int timeout_ms) const
+    {
+        int xc = -1, yc = -1;
+        const Response resp = next_event(xc, yc, timeout_ms);
+        return { resp, xc, yc };
+    }
+
+private:
+    // Ждёт следующего события SDL, не нагружая процессор, и переводит его в ответ игроку.
+    // Изменение размера и перекрытие окна обрабатываются здесь же (доска перерисовывается), для них
+    // и для кликов мимо доски и кнопок возвращается Response::OK. Для клика по доске xc, yc - клетка.
+    // timeout_ms - сколько ждать события (-1 - без ограничения); если события не было, возвращается Response::OK.
+    Response next_event(int& xc, int& yc, const int timeout_ms = -1) const
+    {
+        SDL_Event windowEvent;
+        xc = -1;
+        yc = -1;
+        board->present(); // Перед ожиданием показываем все накопившиеся изменения доски одним кадром
+        if (timeout_ms >= 0)
+        {
+            if (!SDL_WaitEventTimeout(&windowEvent, timeout_ms)) // Событий не было
+                return Response::OK;
+        }
+        else if (!SDL_WaitEvent(&windowEvent)) // Ошибка SDL: ждать событий больше нельзя
+            return Response::QUIT;
+        switch (windowEvent.type)
+        {
+        case SDL_QUIT:
+            return Response::QUIT; // Игрок закрыл окно, завершаем игру
+        case SDL_MOUSEBUTTONDOWN: { // Игрок кликнул мышью
+            // Преобразуем координаты из пикселей в систему координат доски
+            const int x = int(windowEvent.button.y / (board->H / 10) - 1);
+            const int y = int(windowEvent.button.x / (board->W / 10) - 1);
+            if (x == -1 && y == -1)
+                return Response::BACK; // Игрок хочет отменить ход
+            if (x == -1 && y == 8)
+                return Response::REPLAY; // Игрок хочет переиграть
+            if (x >= 0 && x < 8 && y >= 0 && y < 8)
             {
-                switch (windowEvent.type)
-                {
-                case SDL_QUIT:
-                    resp = Response::QUIT;  // Игрок закрыл окно, завершаем игру
-                    break;
-                case SDL_WINDOWEVENT_SIZE_CHANGED:
-                    board->reset_window_size(); // Если изменился размер окна, пересчитываем размеры доски
-                    break;
-                case SDL_MOUSEBUTTONDOWN: { // Если игрок кликнул мышью
-                    int x = windowEvent.motion.x;
-                    int y = windowEvent.motion.y;
-                    int xc = int(y / (board->H / 10) - 1);
-                    int yc = int(x / (board->W / 10) - 1);
-                    if (xc == -1 && yc == 8) // Если клик в зоне "переиграть"
-                        resp = Response::REPLAY;
-                }
-                                        break;
-                }
-                if (resp != Response::OK) // Если есть действие игрока, завершаем ожидание
-                    break;
+                xc = x;
+                yc = y;
+                return Response::CELL; // Игрок выбрал клетку на доске
             }
+            return Response::OK; // Недопустимый клик, игнорируем его
+        }
+        case SDL_RENDER_TARGETS_RESET: // Содержимое кэша доски потеряно
+            board->reset_window_size();
+            return Response::OK;
+        case SDL_WINDOWEVENT:
+            if (windowEvent.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
+                board->reset_window_size(); // Размер окна изменился, пересчитываем размеры доски
+            else if (windowEvent.window.event == SDL_WINDOWEVENT_EXPOSED)
+                board->invalidate(); // Окно было перекрыто, кадр нужно вывести заново
+            return Response::OK;
+        default:
+            return Response::OK;
         }
-        return resp; // Возвращаем результат ввода игрока
     }
 
 private:
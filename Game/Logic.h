@@ -1,383 +1,427 @@
 #pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <future>
+#include <fstream>
+#include <memory>
+#include <mutex>
 #include <random>
+#include <sstream>
+#include <thread>
 #include <vector>
 
 #include "../Models/Move.h"
-#include "Board.h"
+#include "../Models/MoveList.h"
+#include "../Models/Position.h"
+#include "../Models/SearchCounters.h"
 #include "Config.h"
+#include "FeatureEval.h"
+#include "MoveGen.h"
+#include "OpeningBook.h"
+#include "Search.h"
+#include "Tablebase.h"
+#include "TranspositionTable.h"
+#include "Zobrist.h"
+
+// Настройки бота (раздел "Bot" файла settings.json)
+struct bot_options
+{
+    search_settings search; // Метод оценки, уровень оптимизации и время на ход
+    size_t tt_size_mb = 32; // Размер таблицы транспозиций в мегабайтах
+    unsigned threads = 1;   // Количество потоков поиска (0 - по числу ядер процессора)
+    unsigned seed = 0;      // Зерно генераторов случайных чисел
+    string tablebase_path;  // Файл таблиц окончаний (пустая строка - без таблиц)
+    string book_path;       // Файл дебютной книги (пустая строка - без книги)
+    string weights_path;    // Файл весов метода оценки "Features" (пустая строка - обученные по умолчанию)
+    string stats_path;      // Файл счётчиков поиска, по строке JSON на ход (только при сборке с CHECKERS_STATS)
+};
 
+// Итоги последнего поиска
+struct search_stats
+{
+    int depth = -1;   // Глубина последней завершённой итерации (-1 - поиска не было)
+    size_t nodes = 0; // Количество просмотренных узлов во всех потоках
+};
 
-const double INF = 1e9; // Константа, обозначающая "бесконечность" для алгоритма минимакса
-
-class Logic
+// Размышление бота во время хода человека (см. Logic::start_ponder)
+struct ponder_state
 {
-public:
-    // Конструктор класса, принимает указатели на игровую доску и конфигурацию
-    Logic(Board* board, Config* config) : board(board), config(config)
+    // Готовый ответ бота на один из ходов человека
+    struct reply
+    {
+        uint64_t hash; // Хеш позиции после хода человека (как pos.hash в Logic::find_best_turn)
+        bit_move move; // Лучший ход бота
+        int depth;     // Глубина, на которую он найден
+    };
+
+    explicit ponder_state(const unsigned seed) : search(seed)
     {
-        rand_eng = std::default_random_engine(
-            !((*config)("Bot", "NoRandom")) ? unsigned(time(0)) : 0); // Инициализация генератора случайных чисел
-        scoring_mode = (*config)("Bot", "BotScoringType"); // Тип оценки ходов (например, на основе количества фигур)
-        optimization = (*config)("Bot", "Optimization"); // Уровень оптимизации бота
     }
-    // Функция находит лучшие ходы для бота, используя алгоритм минимакса с альфа-бета отсечением.
-    vector<move_pos> find_best_turns(const bool color)
+    ~ponder_state()
     {
-        next_best_state.clear(); // Очищаем вектор состояний
-        next_move.clear(); // Очищаем вектор ходов
-
-        // Запускаем поиск лучшего хода с начальным состоянием доски
-        find_first_best_turn(board->get_board(), color, -1, -1, 0);
-
-        // Формируем список ходов, начиная с корневого состояния
-        int cur_state = 0;
-        vector<move_pos> res;
-        do
-        {
-            res.push_back(next_move[cur_state]);
-            cur_state = next_best_state[cur_state];
-        } while (cur_state != -1 && next_move[cur_state].x != -1);
-
-        return res; // Возвращаем лучший найденный ход
+        join();
     }
-
-    // Функция ищет лучший первый ход для бота, используя минимаксный алгоритм.
-    double find_first_best_turn(vector<vector<POS_T>> mtx, const bool color, const POS_T x, const POS_T y, size_t state,
-        double alpha = -1)
+    // Останавливает поток размышления и дожидается его завершения
+    void join()
     {
-        next_best_state.push_back(-1); // Добавляем новое состояние с изначальным значением -1
-        next_move.emplace_back(-1, -1, -1, -1); // Добавляем фиктивный ход в вектор
-
-        double best_score = -INF; // Инициализируем наихудший возможный счёт
+        stop = true;
+        if (worker.joinable())
+            worker.join();
+    }
 
-        if (state != 0) // Если это не начальное состояние, находим доступные ходы
-            find_turns(x, y, mtx);
+    thread worker;
+    atomic<bool> stop{ false };
+    Search search;           // Поиск потока размышления (таблица транспозиций общая с ботом)
+    search_settings settings; // Настройки бота без ограничения времени: размышление прерывается только флагом stop
+    vector<reply> replies;   // Ответы, найденные на полную глубину. Читаются только после join()
+};
 
-        auto turns_now = turns; // Копируем найденные ходы
-        bool have_beats_now = have_beats; // Проверяем, есть ли возможность побить шашку
+// Управление поиском из другого потока (см. Logic::find_best_turns_async)
+struct search_control
+{
+    atomic<bool> stop{ false }; // Флаг остановки поиска, общий для всех потоков поиска
+    search_progress progress;   // Ход поиска главного потока
+};
 
-        // Если нет ударов и это не начальное состояние, переключаем ход на другого игрока
-        if (!have_beats_now && state != 0)
+// Класс Logic - правила игры и бот. Работает с упакованной позицией и не зависит от SDL и Board,
+// поэтому его можно использовать без окна (см. Tools).
+class Logic
+{
+public:
+    // Конструктор класса, читает настройки бота из конфигурации
+    explicit Logic(Config* config) : Logic(read_options(*config))
+    {
+    }
+    // Конструктор с явными настройками бота
+    explicit Logic(const bot_options& options)
+        : stats_path(options.stats_path), settings(options.search), tt(new TranspositionTable(options.tt_size_mb))
+    {
+        rand_eng = std::default_random_engine(options.seed); // Инициализация генератора случайных чисел
+        ponder.reset(new ponder_state(options.seed + 1000));
+        control.reset(new search_control());
+        // Таблицы окончаний необязательны: если файла нет, бот просто ищет дальше
+        if (!options.tablebase_path.empty())
         {
-            return find_best_turns_rec(mtx, !color, 0, alpha);
+            tablebase.reset(new Tablebase());
+            if (tablebase->load(options.tablebase_path))
+                settings.tablebase = tablebase.get();
+            else
+                tablebase.reset();
         }
-
-        // Перебираем все возможные ходы
-        for (auto turn : turns_now)
+        // Веса лежат в куче, чтобы указатель на них в settings не менялся при перемещении Logic.
+        // Если файла весов нет, остаются обученные по умолчанию.
+        features.reset(new FeatureEval());
+        if (!options.weights_path.empty())
+            features->load(options.weights_path);
+        settings.features = features.get();
+        if (!options.book_path.empty())
         {
-            size_t next_state = next_move.size(); // Запоминаем индекс следующего состояния
-            double score; // Оценка хода
-
-            if (have_beats_now) // Если у нас есть возможность побить шашку, продолжаем серию ударов
-            {
-                score = find_first_best_turn(make_turn(mtx, turn), color, turn.x2, turn.y2, next_state, best_score);
-            }
-            else // Если нет ударов, передаём ход противнику
-            {
-                score = find_best_turns_rec(make_turn(mtx, turn), !color, 0, best_score);
-            }
-
-            // Если ход лучше предыдущего, обновляем лучшую оценку и лучший ход
-            if (score > best_score)
-            {
-                best_score = score;
-                next_best_state[state] = have_beats_now ? int(next_state) : -1;
-                next_move[state] = turn;
-            }
+            book.reset(new OpeningBook());
+            if (!book->load(options.book_path))
+                book.reset();
         }
-        return best_score; // Возвращаем оценку лучшего найденного хода
+        unsigned threads = options.threads;
+        if (threads == 0)
+            threads = max(1u, thread::hardware_concurrency());
+        // У каждого потока свой генератор, иначе потоки перебирали бы дерево в одном и том же порядке
+        for (unsigned i = 0; i < threads; ++i)
+            workers.emplace_back(options.seed + i);
+        workers[0].progress = &control->progress;
     }
-
-    // Рекурсивная функция минимакса с альфа-бета отсечением.
-    // color - чей ход (0 - белые, 1 - чёрные)
-    // depth - текущая глубина поиска
-    double find_best_turns_rec(vector<vector<POS_T>> mtx, const bool color, const size_t depth, double alpha = -INF,
-        double beta = INF, const POS_T x = -1, const POS_T y = -1)
+    // Поток размышления читает таблицу транспозиций, таблицы окончаний и веса оценки. Все они лежат в куче,
+    // поэтому при перемещении Logic поток продолжает работать с теми же объектами. При присваивании первым
+    // заменяется ponder (его деструктор останавливает старый поток), и только потом то, что поток читал.
+    Logic(Logic&&) = default;
+    Logic& operator=(Logic&&) = default;
+    ~Logic()
     {
-        if (depth == Max_depth) // Если достигли максимальной глубины, оцениваем позицию
-        {
-            return calc_score(mtx, color);
-        }
+        if (ponder) // Объект, из которого переместили, ничего не размышляет
+            stop_ponder();
+    }
 
-        if (x != -1) // Если продолжаем серию ударов, проверяем доступные ходы для этой шашки
-        {
-            find_turns(x, y, mtx);
-        }
-        else // Иначе ищем все возможные ходы для игрока
-        {
-            find_turns(color, mtx);
-        }
+    // Читает настройки бота из конфигурации
+    static bot_options read_options(const Config& config)
+    {
+        bot_options options;
+        const string scoring_mode = config("Bot", "BotScoringType"); // Тип оценки ходов (например, на основе количества фигур)
+        options.search.scoring = scoring_mode == "Features"
+            ? Scoring::FEATURES
+            : (scoring_mode == "NumberAndPotential" ? Scoring::NUMBER_AND_POTENTIAL : Scoring::NUMBER_ONLY);
+        const string optimization = config("Bot", "Optimization"); // Уровень оптимизации бота
+        options.search.pruning = optimization == "O0" ? Pruning::NONE : Pruning::ALPHA_BETA;
+        options.search.time_limit_ms = config("Bot", "BotTimeMS"); // Время на обдумывание хода (0 - без ограничения)
+        options.search.quiescence_nodes = config("Bot", "QuiescenceNodes"); // Поиск взятий за горизонтом
+        options.search.late_move_reductions = config("Bot", "LateMoveReductions"); // Сокращение поздних тихих ходов
+        options.search.futility_pruning = config("Bot", "FutilityPruning"); // Отсечение безнадёжных тихих ходов
+        options.tt_size_mb = size_t(config("Bot", "TTSizeMB"));
+        options.threads = config("Bot", "Threads");
+        options.seed = !(config("Bot", "NoRandom")) ? unsigned(time(0)) : 0;
+        const string tablebase_file = config("Bot", "Tablebase");
+        if (!tablebase_file.empty())
+            options.tablebase_path = project_path + tablebase_file;
+        const string book_file = config("Bot", "OpeningBook");
+        if (!book_file.empty())
+            options.book_path = project_path + book_file;
+        const string weights_file = config("Bot", "EvalWeights");
+        if (!weights_file.empty())
+            options.weights_path = project_path + weights_file;
+        const string stats_file = config("Bot", "StatsFile");
+        if (!stats_file.empty())
+            options.stats_path = project_path + stats_file;
+        return options;
+    }
 
-        auto turns_now = turns; // Получаем найденные ходы
-        bool have_beats_now = have_beats; // Проверяем, есть ли возможность побить шашку
+    // Функция находит лучшие ходы для бота и разворачивает найденный ход (вместе со всей серией взятий)
+    // в последовательность шагов для доски
+    vector<move_pos> find_best_turns(const position& board_pos, const bool color)
+    {
+        const bit_move best = find_best_turn(board_pos, color);
+        if (best.from == -1) // Ходов нет
+            return {};
+        return MoveGen::to_turns(best);
+    }
 
-        if (!have_beats_now && x != -1) // Если удары закончились, передаём ход противнику
-        {
-            return find_best_turns_rec(mtx, !color, depth + 1, alpha, beta);
-        }
+    // Запускает поиск лучших ходов бота в отдельном потоке, чтобы окно продолжало обрабатывать события.
+    // Пока поиск идёт, ход поиска можно узнать через progress(), а остановить - через cancel_search()
+    // (тогда играется лучший ход последней завершённой итерации). Пока future не готов, других методов
+    // Logic вызывать нельзя.
+    future<vector<move_pos>> find_best_turns_async(const position& board_pos, const bool color)
+    {
+        control->stop = false;
+        return async(launch::async, [this, board_pos, color]() {
+            const bit_move best = search_best_turn(board_pos, color);
+            return best.from == -1 ? vector<move_pos>() : MoveGen::to_turns(best);
+        });
+    }
 
-        if (turns.empty()) // Если ходов нет, значит это проигрыш
-        {
-            return (depth % 2 == 0) ? INF : 0;
-        }
+    // Останавливает идущий поиск (из любого потока)
+    void cancel_search()
+    {
+        control->stop = true;
+    }
 
-        // Минимальная и максимальная оценки
-        double min_score = INF;
-        double max_score = -INF;
+    // Ход идущего поиска: глубина последней завершённой итерации и узлы главного потока
+    search_stats progress() const
+    {
+        search_stats res;
+        res.depth = control->progress.depth.load(memory_order_relaxed);
+        res.nodes = control->progress.nodes.load(memory_order_relaxed);
+        return res;
+    }
 
-        // Перебираем все возможные ходы
-        for (auto turn : turns_now)
-        {
-            double score;
-            if (!have_beats_now && x == -1) // Если ход обычный, передаём ход противнику
-            {
-                score = find_best_turns_rec(make_turn(mtx, turn), !color, depth + 1, alpha, beta);
-            }
-            else // Если ход с рубкой, продолжаем серию ударов
-            {
-                score = find_best_turns_rec(make_turn(mtx, turn), color, depth, alpha, beta, turn.x2, turn.y2);
-            }
+    // Функция находит лучший ход для бота, используя алгоритм минимакса с альфа-бета отсечением.
+    // Поиск идёт с итеративным углублением: глубина 0, 1, 2, ... до Max_depth, пока не кончится время на ход.
+    // При нескольких потоках (Lazy SMP) все потоки ищут одну и ту же позицию и делятся результатами через
+    // общую таблицу транспозиций; нечётные вспомогательные потоки начинают на глубину больше, чтобы
+    // заполнять таблицу впереди главного. Возвращается ход потока с самой глубокой завершённой итерацией.
+    bit_move find_best_turn(const position& board_pos, const bool color)
+    {
+        control->stop = false;
+        return search_best_turn(board_pos, color);
+    }
 
-            min_score = min(min_score, score);
-            max_score = max(max_score, score);
+    // Начинает размышление в фоне, пока думает человек (color - его цвет): бот по очереди ищет ответы
+    // на все его возможные ходы на глубину depth. Поиск заполняет общую таблицу транспозиций, а ответы,
+    // найденные на полную глубину, find_best_turn отдаёт сразу, без поиска.
+    void start_ponder(const position& board_pos, const bool color, const int depth)
+    {
+        stop_ponder();
+        ponder->replies.clear();
+        ponder->stop = false;
+        ponder->settings = settings;
+        ponder->settings.time_limit_ms = 0;
+        // Поток получает сами объекты, а не this: Logic может быть перемещён, пока поток работает
+        ponder_state* state = ponder.get();
+        TranspositionTable* table = tt.get();
+        ponder->worker = thread([state, table, board_pos, color, depth]() {
+            ponder_replies(state, table, board_pos, color, depth);
+        });
+    }
 
-            // Альфа-бета отсечение
-            if (depth % 2 == 0) // Ход бота (максимизирующий игрок)
-            {
-                alpha = max(alpha, max_score);
-            }
-            else // Ход противника (минимизирующий игрок)
-            {
-                beta = min(beta, min_score);
-            }
+    // Останавливает размышление (человек сходил, отменил ход, начал новую партию или вышел)
+    void stop_ponder()
+    {
+        ponder->join();
+    }
 
-            // Если нашли достаточно хороший ход, прерываем дальнейший поиск
-            if (optimization != "O0" && alpha >= beta)
-            {
-                return (depth % 2 == 0) ? max_score : min_score;
-            }
-        }
+    // Найти все возможные ходы для заданного цвета (0 — белые, 1 — чёрные).
+    // `pos` — текущее состояние игровой доски.
+    void find_turns(const position& pos, const bool color)
+    {
+        have_beats = MoveGen::side_turns(pos, color, turns); // Ходы всех фигур с учётом обязательного взятия
+        shuffle(turns.begin(), turns.end(), rand_eng); // Перемешиваем ходы (если активирован случайный порядок)
+    }
 
-        return (depth % 2 == 0) ? max_score : min_score; // Возвращаем наилучшую найденную оценку
+    // Найти все возможные ходы для заданной фигуры по её координатам (x, y).
+    // `pos` — текущее состояние игровой доски.
+    void find_turns(const position& pos, const POS_T x, const POS_T y)
+    {
+        have_beats = MoveGen::piece_turns(pos, x, y, turns); // Если у фигуры есть удары, возвращаются только они
     }
 
+public:
+    vector<move_pos> turns; // Список возможных ходов
+    bool have_beats; // Флаг наличия ударов (если true, шашки могут бить)
+    int Max_depth; // Максимальная глубина поиска для алгоритма минимакса
+    search_stats stats; // Итоги последнего поиска
+    search_counters counters; // Счётчики последнего поиска во всех потоках (только при сборке с CHECKERS_STATS)
+
 private:
-    // Функция выполняет виртуальный ход и возвращает новую копию доски после этого хода
-    vector<vector<POS_T>> make_turn(vector<vector<POS_T>> mtx, move_pos turn) const
+    // Хеш позиции для поиска бота цвета color. Оценки в таблице транспозиций считаются с точки зрения бота,
+    // поэтому цвет бота входит в хеш.
+    static uint64_t bot_hash(const position& pos, const bool color)
     {
-        if (turn.xb != -1) // Если был захват шашки, удаляем побитую фигуру
-            mtx[turn.xb][turn.yb] = 0;
-        // Если обычная шашка дошла до конца доски, она становится дамкой
-        if ((mtx[turn.x][turn.y] == 1 && turn.x2 == 0) || (mtx[turn.x][turn.y] == 2 && turn.x2 == 7))
-            mtx[turn.x][turn.y] += 2;
-        // Перемещаем шашку на новую позицию
-        mtx[turn.x2][turn.y2] = mtx[turn.x][turn.y];
-        // Очищаем предыдущую клетку
-        mtx[turn.x][turn.y] = 0;
-        return mtx;  // Возвращаем обновлённое состояние доски
+        return Zobrist::hash(pos, color) ^ (color ? Zobrist::black_bot() : 0);
     }
 
-    // Функция оценивает текущее состояние доски и возвращает числовой показатель (чем выше, тем лучше для бота)
-    double calc_score(const vector<vector<POS_T>>& mtx, const bool first_bot_color) const
+    // Поиск лучшего хода для find_best_turn и find_best_turns_async. Флаг остановки сбрасывает вызывающий:
+    // так отмена, пришедшая до начала поиска, не теряется.
+    bit_move search_best_turn(const position& board_pos, const bool color)
     {
-        // color - определяет, кто является максимизирующим игроком (бот или противник)
-        double w = 0, wq = 0, b = 0, bq = 0;
-        // Подсчёт количества шашек и дамок на доске.
-        for (POS_T i = 0; i < 8; ++i)
+        stop_ponder();
+        position pos = board_pos;
+        pos.hash = bot_hash(pos, color);
+        stats = search_stats();
+
+        move_list turns_now;
+        MoveGen::generate(pos, color, turns_now);
+        if (turns_now.empty()) // Ходов нет
+            return bit_move();
+        if (turns_now.size() == 1) // Единственный ход искать не нужно
+            return turns_now.front();
+        if (book) // Позиция из дебютной книги: ход выбирается случайно с учётом весов, без поиска
         {
-            for (POS_T j = 0; j < 8; ++j)
+            const int book_move = book->choose(pos, color, turns_now, rand_eng);
+            if (book_move != -1)
+                return turns_now[size_t(book_move)];
+        }
+        if (tablebase) // Решённое окончание: ход берётся из таблиц без поиска
+        {
+            const int tb_move = tablebase->best_move(pos, color, turns_now);
+            if (tb_move != -1)
+                return turns_now[size_t(tb_move)];
+        }
+
+        const int max_depth = min(Max_depth, MAX_PLY - 1);
+        for (const auto& reply : ponder->replies)
+        {
+            if (reply.hash == pos.hash && reply.depth >= max_depth) // Ход уже найден во время хода человека
             {
-                w += (mtx[i][j] == 1); // Количество белых шашек
-                wq += (mtx[i][j] == 3); // Количество белых дамок
-                b += (mtx[i][j] == 2); // Количество чёрных шашек
-                bq += (mtx[i][j] == 4); // Количество чёрных дамок
-                // Если используется метод "NumberAndPotential", учитываем "потенциал" шашек (приближенность к дамке)
-                if (scoring_mode == "NumberAndPotential")
-                {
-                    w += 0.05 * (mtx[i][j] == 1) * (7 - i); // Чем ближе к противоположному краю, тем выше оценка
-                    b += 0.05 * (mtx[i][j] == 2) * (i);
-                }
+                stats.depth = reply.depth;
+                return reply.move;
             }
         }
-        // Если бот играет за чёрных, меняем местами значения
-        if (!first_bot_color)
+        const auto start = chrono::steady_clock::now();
+        atomic<bool>& stop = control->stop;
+        control->progress.depth = -1;
+        control->progress.nodes = 0;
+        vector<thread> helpers;
+        for (size_t i = 1; i < workers.size(); ++i)
         {
-            swap(b, w);
-            swap(bq, wq);
+            helpers.emplace_back([this, &pos, color, max_depth, start, &stop, i]() {
+                workers[i].iterate(pos, color, min(int(i % 2), max_depth), max_depth, false, tt.get(), &settings, &stop,
+                    start);
+            });
         }
-        // Если у бота не осталось фигур, это поражение (возвращаем "бесконечность")
-        if (w + wq == 0)
-            return INF;
-        // Если у противника не осталось фигур, это победа (возвращаем 0)
-        if (b + bq == 0)
-            return 0;
-        // Коэффициент значимости дамок (по умолчанию 4, но если учёт потенциала включён — 5)
-        int q_coef = 4;
-        if (scoring_mode == "NumberAndPotential")
+        workers[0].iterate(pos, color, 0, max_depth, true, tt.get(), &settings, &stop, start);
+        stop = true; // Главный поток закончил, останавливаем остальные
+        for (auto& th : helpers)
+            th.join();
+
+        const Search* best = &workers[0];
+        for (const auto& worker : workers)
         {
-            q_coef = 5;
+            if (worker.completed_depth > best->completed_depth)
+                best = &worker;
+            stats.nodes += worker.nodes;
         }
-        // Оцениваем силу позиций: чем выше значение, тем выгоднее текущая позиция для бота
-        return (b + bq * q_coef) / (w + wq * q_coef);
-    }
-
-
-public:
-    // Найти все возможные ходы для заданного цвета (0 — белые, 1 — чёрные)
-    void find_turns(const bool color)
-    {
-        find_turns(color, board->get_board());
-    }
-    // Найти все возможные ходы для заданной фигуры по её координатам (x, y)
-    void find_turns(const POS_T x, const POS_T y)
-    {
-        find_turns(x, y, board->get_board());
+        stats.depth = best->completed_depth;
+#ifdef CHECKERS_STATS
+        counters = workers[0].counters;
+        for (size_t i = 1; i < workers.size(); ++i)
+            counters.add(workers[i].counters);
+        if (!stats_path.empty())
+            write_counters(color, chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+#endif
+        return best->best_move;
     }
 
-private:
-    // Перегруженная функция, находит все возможные ходы для указанного цвета.
-    // `color` — цвет игрока (0 — белые, 1 — чёрные).
-    // `mtx` — текущее состояние игровой доски.
-    void find_turns(const bool color, const vector<vector<POS_T>>& mtx)
+#ifdef CHECKERS_STATS
+    // Дописывает итоги поиска в stats_path строкой JSON. Узлы - внутренние узлы дерева (листья считаются
+    // отдельно), итерации и коэффициент ветвления - по главному потоку.
+    void write_counters(const bool color, const double ms) const
     {
-        vector<move_pos> res_turns; // Вектор возможных ходов
-        bool have_beats_before = false; // Флаг, были ли удары
-        // Проход по всей доске для поиска возможных ходов
-        for (POS_T i = 0; i < 8; ++i)
+        ostringstream line;
+        line << "{\"color\":\"" << (color ? "black" : "white") << "\",\"scoring\":\""
+             << (settings.scoring == Scoring::FEATURES
+                        ? "Features"
+                        : (settings.scoring == Scoring::NUMBER_AND_POTENTIAL ? "NumberAndPotential" : "NumberOnly"))
+             << "\",\"pruning\":\"" << (settings.pruning == Pruning::NONE ? "none" : "alpha_beta")
+             << "\",\"lmr\":" << (settings.late_move_reductions ? "true" : "false")
+             << ",\"futility\":" << (settings.futility_pruning ? "true" : "false")
+             << ",\"threads\":" << workers.size() << ",\"depth\":" << stats.depth << ",\"ms\":" << ms
+             << ",\"nodes\":" << stats.nodes << ",\"nps\":" << (ms > 0 ? size_t(stats.nodes * 1000 / ms) : 0)
+             << ",\"leaves\":" << counters.leaves << ",\"qnodes\":" << counters.qnodes << ",\"tt_probes\":" << counters.tt_probes
+             << ",\"tt_hits\":" << counters.tt_hits << ",\"cutoffs\":[";
+        for (int i = 0; i < search_counters::MAX_CUTOFF_INDEX; ++i)
+            line << (i ? "," : "") << counters.cutoffs[i];
+        line << "],\"max_chain\":" << counters.max_chain;
+        // Эффективный коэффициент ветвления: во сколько раз последняя итерация больше предыдущей
+        const int n = counters.iterations;
+        double ebf = 0;
+        if (n >= 3 && counters.iteration_nodes[n - 2] > counters.iteration_nodes[n - 3])
+            ebf = double(counters.iteration_nodes[n - 1] - counters.iteration_nodes[n - 2]) /
+                double(counters.iteration_nodes[n - 2] - counters.iteration_nodes[n - 3]);
+        line << ",\"ebf\":" << ebf << ",\"iterations\":[";
+        for (int d = 0; d < n; ++d)
         {
-            for (POS_T j = 0; j < 8; ++j)
-            {
-                // Если клетка занята и её цвет совпадает с текущим игроком
-                if (mtx[i][j] != 0 && (static_cast<int>(mtx[i][j]) % 2) != static_cast<int>(color))
-
-                {
-                    find_turns(i, j, mtx); // Найти все возможные ходы для данной шашки
-                    // Если появилась возможность бить шашку и раньше не было ударов — очищаем список ходов
-                    if (have_beats && !have_beats_before)
-                    {
-                        have_beats_before = true;
-                        res_turns.clear();
-                    }
-                    // Добавляем ходы в список
-                    if ((have_beats_before && have_beats) || !have_beats_before)
-                    {
-                        res_turns.insert(res_turns.end(), turns.begin(), turns.end());
-                    }
-                }
-            }
+            line << (d ? "," : "") << "{\"depth\":" << d << ",\"nodes\":"
+                 << counters.iteration_nodes[d] - (d ? counters.iteration_nodes[d - 1] : 0) << ",\"ms\":"
+                 << counters.iteration_ms[d] - (d ? counters.iteration_ms[d - 1] : 0) << "}";
         }
-        turns = res_turns; // Обновляем список ходов
-        shuffle(turns.begin(), turns.end(), rand_eng); // Перемешиваем ходы (если активирован случайный порядок)
-        have_beats = have_beats_before; // Обновляем флаг ударов
+        line << "]}\n";
+        static mutex file_mutex; // В один файл могут писать несколько ботов (например, в SelfPlay)
+        lock_guard<mutex> lock(file_mutex);
+        ofstream fout(stats_path, ios_base::app);
+        fout << line.str();
     }
+#endif
 
-    // Перегруженная функция, находит возможные ходы для одной фигуры.
-   // `x`, `y` — координаты фигуры.
-   // `mtx` — текущее состояние игровой доски.
-    void find_turns(const POS_T x, const POS_T y, const vector<vector<POS_T>>& mtx)
+    // Поток размышления: ищет ответ бота на каждый ход человека, пока его не остановят
+    static void ponder_replies(ponder_state* state, TranspositionTable* table, const position& board_pos,
+        const bool color, const int depth)
     {
-        turns.clear();  // Очищаем список возможных ходов
-        have_beats = false; // Сбрасываем флаг наличия ударов
-        POS_T type = mtx[x][y]; // Получаем тип фигуры (обычная шашка или дамка)
-        // Проверяем возможность захвата (ударов)
-        switch (type)
-        {
-        case 1: // Белая шашка
-        case 2: // Чёрная шашка
-            // check pieces
-            for (POS_T i = x - 2; i <= x + 2; i += 4) // Проверка диагоналей
-            {
-                for (POS_T j = y - 2; j <= y + 2; j += 4)
-                {
-                    if (i < 0 || i > 7 || j < 0 || j > 7) // Проверяем границы доски
-                        continue;
-                    POS_T xb = (x + i) / 2, yb = (y + j) / 2; // Координаты возможной побитой шашки
-                    // Проверяем, можно ли сделать удар
-                    if (mtx[i][j] || !mtx[xb][yb] || mtx[xb][yb] % 2 == type % 2)
-                        continue;
-                    turns.emplace_back(x, y, i, j, xb, yb);  // Добавляем удар в список возможных ходов
-                }
-            }
-            break;
-        default:  // Дамка (белая или чёрная)
-            // check queens
-            for (POS_T i = -1; i <= 1; i += 2)
-            {
-                for (POS_T j = -1; j <= 1; j += 2)
-                {
-                    POS_T xb = -1, yb = -1;
-                    // Дамка может двигаться по диагонали на любое количество клеток
-                    for (POS_T i2 = x + i, j2 = y + j; i2 != 8 && j2 != 8 && i2 != -1 && j2 != -1; i2 += i, j2 += j)
-                    {
-                        if (mtx[i2][j2])
-                        {
-                            if (mtx[i2][j2] % 2 == type % 2 || (mtx[i2][j2] % 2 != type % 2 && xb != -1))
-                            {
-                                break;
-                            }
-                            xb = i2;
-                            yb = j2;
-                        }
-                        if (xb != -1 && xb != i2)
-                        {
-                            turns.emplace_back(x, y, i2, j2, xb, yb);  // Добавляем возможный ход дамки
-                        }
-                    }
-                }
-            }
-            break;
-        }
-        // Если были найдены удары, останавливаем дальнейший поиск
-        if (!turns.empty())
-        {
-            have_beats = true;
-            return;
-        }
-        // Если ударов нет, проверяем обычные ходы
-        switch (type)
-        {
-        case 1: // Белая шашка
-        case 2: // Чёрная шашка
-            // check pieces
+        const int max_depth = min(depth, MAX_PLY - 1);
+        move_list moves, answers;
+        MoveGen::generate(board_pos, color, moves);
+        const auto start = chrono::steady_clock::now();
+        for (const auto& move : moves)
         {
-            POS_T i = ((type % 2) ? x - 1 : x + 1); // Вычисляем направление хода
-            for (POS_T j = y - 1; j <= y + 1; j += 2)
-            {
-                if (i < 0 || i > 7 || j < 0 || j > 7 || mtx[i][j])
-                    continue;
-                turns.emplace_back(x, y, i, j);  // Добавляем обычный ход
-            }
-            break;
-        }
-        default: // Дамка
-            // check queens
-            for (POS_T i = -1; i <= 1; i += 2)
-            {
-                for (POS_T j = -1; j <= 1; j += 2)
-                {
-                    for (POS_T i2 = x + i, j2 = y + j; i2 != 8 && j2 != 8 && i2 != -1 && j2 != -1; i2 += i, j2 += j)
-                    {
-                        if (mtx[i2][j2])
-                            break;
-                        turns.emplace_back(x, y, i2, j2); // Добавляем возможный ход дамки
-                    }
-                }
-            }
-            break;
+            if (state->stop)
+                return;
+            position pos = MoveGen::make_move(board_pos, move, color);
+            pos.hash = bot_hash(pos, !color);
+            MoveGen::generate(pos, !color, answers);
+            if (answers.size() < 2) // Ответ находится без поиска
+                continue;
+            Search& search = state->search;
+            search.iterate(pos, !color, 0, max_depth, false, table, &state->settings, &state->stop, start);
+            if (search.completed_depth >= max_depth)
+                state->replies.push_back({ pos.hash, search.best_move, search.completed_depth });
         }
     }
 
-public:
-    vector<move_pos> turns; // Список возможных ходов
-    bool have_beats; // Флаг наличия ударов (если true, шашки могут бить)
-    int Max_depth; // Максимальная глубина поиска для алгоритма минимакса
-
-private:
-    default_random_engine rand_eng; // Генератор случайных чисел (для случайного выбора ходов бота)
-    string scoring_mode; // Метод оценки позиции (например, "NumberAndPotential")
-    string optimization;  // Оптимизационные параметры для алгоритма поиска
-    vector<move_pos> next_move;  // Ходы, выбранные ботом на каждом уровне поиска
-    vector<int> next_best_state; // Следующие состояния после ходов
-    Board* board;  // Указатель на объект игрового поля
-    Config* config; // Указатель на объект с настройками игры
+    unique_ptr<ponder_state> ponder; // Размышление во время хода человека (объявлено первым: при присваивании
+                                     // поток останавливается раньше, чем заменяются объекты, которые он читает)
+    string stats_path; // Файл счётчиков поиска (пустая строка - не записывать)
+    default_random_engine rand_eng; // Генератор случайных чисел (для случайного порядка ходов)
+    search_settings settings; // Настройки поиска, общие для всех потоков
+    unique_ptr<OpeningBook> book; // Дебютная книга (nullptr - не загружена)
+    unique_ptr<Tablebase> tablebase; // Таблицы окончаний (nullptr - не загружены)
+    unique_ptr<FeatureEval> features; // Веса метода оценки "Features"
+    unique_ptr<TranspositionTable> tt; // Таблица транспозиций, общая для всех ходов одной партии и всех потоков поиска
+    vector<Search> workers; // Потоки поиска: workers[0] работает в вызывающем потоке и следит за временем
+    unique_ptr<search_control> control; // Флаг остановки и ход поиска (в куче, чтобы Logic можно было перемещать)
 };
@@ -0,0 +1,146 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Класс MappedFile отображает файл в память только для чтения. Данные читаются операционной системой
+// по мере обращения, поэтому большие таблицы не нужно загружать целиком при старте.
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other)
+    {
+        *this = std::move(other);
+    }
+    MappedFile& operator=(MappedFile&& other)
+    {
+        if (this != &other)
+        {
+            close();
+#ifdef _WIN32
+            file = other.file;
+            mapping = other.mapping;
+            other.file = INVALID_HANDLE_VALUE;
+            other.mapping = nullptr;
+#else
+            fd = other.fd;
+            other.fd = -1;
+#endif
+            ptr = other.ptr;
+            len = other.len;
+            other.ptr = nullptr;
+            other.len = 0;
+        }
+        return *this;
+    }
+    ~MappedFile()
+    {
+        close();
+    }
+
+    // Отображает файл в память. Возвращает false, если файл не открылся или пуст.
+    bool open(const std::string& path)
+    {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0)
+        {
+            close();
+            return false;
+        }
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping)
+        {
+            close();
+            return false;
+        }
+        ptr = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        len = size_t(file_size.QuadPart);
+#else
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd == -1)
+            return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0)
+        {
+            close();
+            return false;
+        }
+        void* addr = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        ptr = addr == MAP_FAILED ? nullptr : static_cast<const uint8_t*>(addr);
+        len = size_t(st.st_size);
+#endif
+        if (!ptr)
+        {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    // Закрывает файл
+    void close()
+    {
+#ifdef _WIN32
+        if (ptr)
+            UnmapViewOfFile(ptr);
+        if (mapping)
+            CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE)
+            CloseHandle(file);
+        file = INVALID_HANDLE_VALUE;
+        mapping = nullptr;
+#else
+        if (ptr)
+            munmap(const_cast<uint8_t*>(ptr), len);
+        if (fd != -1)
+            ::close(fd);
+        fd = -1;
+#endif
+        ptr = nullptr;
+        len = 0;
+    }
+
+    const uint8_t* data() const
+    {
+        return ptr;
+    }
+    size_t size() const
+    {
+        return len;
+    }
+
+private:
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+    const uint8_t* ptr = nullptr;
+    size_t len = 0;
+};
@@ -0,0 +1,371 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+#include "../Models/Move.h"
+#include "../Models/MoveList.h"
+#include "../Models/Position.h"
+
+// Класс MoveGen генерирует ходы по упакованной позиции (position) с помощью сдвигов и масок.
+// Направления нумеруются так же, как в переборе (i, j) из {-1, 1}:
+// 0 - вверх-влево, 1 - вверх-вправо, 2 - вниз-влево, 3 - вниз-вправо.
+// Белые шашки ходят вверх (к строке 0), чёрные - вниз (к строке 7).
+class MoveGen
+{
+public:
+    static constexpr uint32_t EVEN_ROWS = 0x0F0F0F0Fu; // Клетки строк 0, 2, 4, 6
+    static constexpr uint32_t ODD_ROWS = 0xF0F0F0F0u;  // Клетки строк 1, 3, 5, 7
+    static constexpr uint32_t LEFT_COL = 0x11111111u;  // Первая игровая клетка каждой строки
+    static constexpr uint32_t RIGHT_COL = 0x88888888u; // Последняя игровая клетка каждой строки
+    static constexpr uint32_t TOP_ROW = 0x0000000Fu;   // Строка превращения белых
+    static constexpr uint32_t BOTTOM_ROW = 0xF0000000u; // Строка превращения чёрных
+
+    // Сдвигает все клетки маски на одну клетку в направлении dir (клетки за краем доски пропадают)
+    static uint32_t shift(const uint32_t b, const int dir)
+    {
+        switch (dir)
+        {
+        case 0:
+            return ((b & EVEN_ROWS) >> 4) | ((b & ODD_ROWS & ~LEFT_COL) >> 5);
+        case 1:
+            return ((b & EVEN_ROWS & ~RIGHT_COL) >> 3) | ((b & ODD_ROWS) >> 4);
+        case 2:
+            return ((b & EVEN_ROWS) << 4) | ((b & ODD_ROWS & ~LEFT_COL) << 3);
+        default:
+            return ((b & EVEN_ROWS & ~RIGHT_COL) << 5) | ((b & ODD_ROWS) << 4);
+        }
+    }
+
+    // Соседняя клетка в направлении dir (-1, если её нет)
+    static int next(const int dir, const int s)
+    {
+        return tables().next[dir][s];
+    }
+
+    // Луч из клетки s в направлении dir (сама клетка не входит)
+    static uint32_t ray(const int dir, const int s)
+    {
+        return tables().ray[dir][s];
+    }
+
+    // Фигуры цвета color (0 - белые, 1 - чёрные)
+    static uint32_t own(const position& pos, const bool color)
+    {
+        return color ? pos.black : pos.white;
+    }
+
+    // Маска фигур цвета color, которые могут бить прямо сейчас
+    static uint32_t capturers(const position& pos, const bool color)
+    {
+        const uint32_t opp = own(pos, !color);
+        const uint32_t empty = ~pos.occupied();
+        const uint32_t men = own(pos, color) & ~pos.kings;
+        uint32_t res = 0;
+        // Шашки: соседняя клетка занята противником, следующая за ней свободна (бить можно во все стороны)
+        for (int dir = 0; dir < 4; ++dir)
+        {
+            res |= men & shift(opp & shift(empty, 3 - dir), 3 - dir);
+        }
+        // Дамки: первая фигура на луче принадлежит противнику, а клетка за ней свободна
+        for (uint32_t queens = own(pos, color) & pos.kings; queens; queens &= queens - 1)
+        {
+            const int s = bit_scan(queens);
+            for (int dir = 0; dir < 4; ++dir)
+            {
+                const int b = first_blocker(dir, ray(dir, s) & ~empty);
+                if (b != -1 && (opp >> b & 1) && next(dir, b) != -1 && (empty >> next(dir, b) & 1))
+                {
+                    res |= 1u << s;
+                    break;
+                }
+            }
+        }
+        return res;
+    }
+
+    // Перебирает все одиночные взятия фигуры из клетки s: f(клетка побитой фигуры, клетка приземления)
+    template <class F> static void for_each_jump(const position& pos, const int s, F&& f)
+    {
+        const bool color = (pos.black >> s) & 1;
+        const uint32_t opp = own(pos, !color);
+        const uint32_t occ = pos.occupied();
+        if (!((pos.kings >> s) & 1))
+        {
+            for (int dir = 0; dir < 4; ++dir)
+            {
+                const int b = next(dir, s);
+                if (b == -1 || !((opp >> b) & 1))
+                    continue;
+                const int l = next(dir, b);
+                if (l != -1 && !((occ >> l) & 1))
+                    f(b, l);
+            }
+            return;
+        }
+        for (int dir = 0; dir < 4; ++dir)
+        {
+            const int b = first_blocker(dir, ray(dir, s) & occ);
+            if (b == -1 || !((opp >> b) & 1))
+                continue;
+            // Приземлиться можно на любую свободную клетку за побитой фигурой до следующей фигуры
+            for_each_on_ray(dir, free_ray(dir, b, occ), [&](const int l) { f(b, l); });
+        }
+    }
+
+    // Перебирает все ходы без взятия фигуры из клетки s: f(клетка назначения)
+    template <class F> static void for_each_step(const position& pos, const int s, F&& f)
+    {
+        const uint32_t occ = pos.occupied();
+        if (!((pos.kings >> s) & 1))
+        {
+            const int dir0 = ((pos.white >> s) & 1) ? 0 : 2; // Белые ходят вверх, чёрные - вниз
+            for (int dir = dir0; dir < dir0 + 2; ++dir)
+            {
+                const int l = next(dir, s);
+                if (l != -1 && !((occ >> l) & 1))
+                    f(l);
+            }
+            return;
+        }
+        for (int dir = 0; dir < 4; ++dir)
+        {
+            for_each_on_ray(dir, free_ray(dir, s, occ), f);
+        }
+    }
+
+    // Ходы одной фигуры (одиночные шаги, как их вводит игрок). Возвращает true, если это взятия.
+    static bool piece_turns(const position& pos, const POS_T x, const POS_T y, std::vector<move_pos>& turns)
+    {
+        turns.clear();
+        const int s = position::square(x, y);
+        for_each_jump(pos, s, [&](const int b, const int l) {
+            turns.emplace_back(x, y, position::row(l), position::col(l), position::row(b), position::col(b));
+        });
+        if (!turns.empty())
+            return true;
+        for_each_step(pos, s, [&](const int l) { turns.emplace_back(x, y, position::row(l), position::col(l)); });
+        return false;
+    }
+
+    // Одиночные шаги всех фигур цвета color с учётом обязательного взятия. Возвращает true, если это взятия.
+    static bool side_turns(const position& pos, const bool color, std::vector<move_pos>& turns)
+    {
+        turns.clear();
+        const uint32_t beaters = capturers(pos, color);
+        for (uint32_t pieces = beaters ? beaters : own(pos, color); pieces; pieces &= pieces - 1)
+        {
+            const int s = bit_scan(pieces);
+            const POS_T x = position::row(s), y = position::col(s);
+            if (beaters)
+            {
+                for_each_jump(pos, s, [&](const int b, const int l) {
+                    turns.emplace_back(x, y, position::row(l), position::col(l), position::row(b), position::col(b));
+                });
+            }
+            else
+            {
+                for_each_step(pos, s, [&](const int l) { turns.emplace_back(x, y, position::row(l), position::col(l)); });
+            }
+        }
+        return beaters != 0;
+    }
+
+    // Все ходы цвета color целиком: серии взятий генерируются до конца. Возвращает true, если это взятия.
+    static bool generate(const position& pos, const bool color, move_list& moves)
+    {
+        moves.clear();
+        const uint32_t beaters = capturers(pos, color);
+        if (beaters)
+        {
+            for (uint32_t pieces = beaters; pieces; pieces &= pieces - 1)
+            {
+                bit_move cur;
+                cur.from = int8_t(bit_scan(pieces));
+                add_beat_series(pos, color, cur.from, cur, moves);
+            }
+            return true;
+        }
+        // Ходы шашек: для каждого направления все шашки сдвигаются одной операцией
+        const uint32_t empty = ~pos.occupied();
+        const uint32_t men = own(pos, color) & ~pos.kings;
+        for (int dir = color ? 2 : 0; dir < (color ? 4 : 2); ++dir)
+        {
+            for (uint32_t targets = shift(men, dir) & empty; targets; targets &= targets - 1)
+            {
+                bit_move m;
+                m.to = int8_t(bit_scan(targets));
+                m.from = int8_t(next(3 - dir, m.to));
+                m.promotion = ((color ? BOTTOM_ROW : TOP_ROW) >> m.to) & 1;
+                moves.push_back(m);
+            }
+        }
+        // Ходы дамок по лучам
+        for (uint32_t queens = own(pos, color) & pos.kings; queens; queens &= queens - 1)
+        {
+            const int s = bit_scan(queens);
+            for (uint32_t targets = queen_steps(s, ~empty); targets; targets &= targets - 1)
+            {
+                bit_move m;
+                m.from = int8_t(s);
+                m.to = int8_t(bit_scan(targets));
+                moves.push_back(m);
+            }
+        }
+        return false;
+    }
+
+    // Выполняет ход цвета color и возвращает новую позицию
+    static position make_move(position pos, const bit_move& m, const bool color)
+    {
+        const uint32_t from = 1u << m.from, to = 1u << m.to;
+        // Коды фигур: 1/2 - белая/чёрная шашка, на 2 больше - дамка
+        const int type = (color ? 2 : 1) + ((pos.kings & from) ? 2 : 0);
+        for (uint32_t beaten = m.captured; beaten; beaten &= beaten - 1)
+        {
+            const int s = bit_scan(beaten);
+            pos.count_piece((color ? 1 : 2) + (((pos.kings >> s) & 1) ? 2 : 0), s, -1);
+        }
+        pos.count_piece(type, m.from, -1);
+        pos.count_piece(m.promotion ? type + 2 : type, m.to, 1);
+        // Сначала снимаем побитые фигуры: фигура может закончить серию на клетке, где стояла побитая
+        if (color)
+            pos.white &= ~m.captured;
+        else
+            pos.black &= ~m.captured;
+        pos.kings &= ~m.captured;
+        uint32_t& side = color ? pos.black : pos.white;
+        side = (side & ~from) | to;
+        if (pos.kings & from)
+            pos.kings = (pos.kings & ~from) | to;
+        else if (m.promotion)
+            pos.kings |= to;
+        return pos;
+    }
+
+    // Переводит ход в последовательность одиночных шагов move_pos (как их выполняет Board)
+    static std::vector<move_pos> to_turns(const bit_move& m)
+    {
+        std::vector<move_pos> res;
+        if (!m.beats)
+        {
+            res.emplace_back(position::row(m.from), position::col(m.from), position::row(m.to), position::col(m.to));
+            return res;
+        }
+        int cur = m.from;
+        for (int i = 0; i < m.beats; ++i)
+        {
+            res.emplace_back(position::row(cur), position::col(cur), position::row(m.path[i]), position::col(m.path[i]),
+                position::row(m.beaten[i]), position::col(m.beaten[i]));
+            cur = m.path[i];
+        }
+        return res;
+    }
+
+private:
+    struct ray_tables
+    {
+        int8_t next[4][32];
+        uint32_t ray[4][32];
+    };
+
+    // Таблицы соседей и лучей строятся один раз при первом обращении
+    static const ray_tables& tables()
+    {
+        static const ray_tables t = build_tables();
+        return t;
+    }
+
+    static ray_tables build_tables()
+    {
+        ray_tables t;
+        for (int dir = 0; dir < 4; ++dir)
+        {
+            for (int s = 0; s < 32; ++s)
+            {
+                const uint32_t n = shift(1u << s, dir);
+                t.next[dir][s] = int8_t(n ? bit_scan(n) : -1);
+            }
+        }
+        for (int dir = 0; dir < 4; ++dir)
+        {
+            for (int s = 0; s < 32; ++s)
+            {
+                t.ray[dir][s] = 0;
+                for (int l = t.next[dir][s]; l != -1; l = t.next[dir][l])
+                    t.ray[dir][s] |= 1u << l;
+            }
+        }
+        return t;
+    }
+
+    // Ближайшая к началу луча клетка из маски: лучи вверх идут по убыванию индексов, вниз - по возрастанию
+    static int first_blocker(const int dir, const uint32_t mask)
+    {
+        if (!mask)
+            return -1;
+        return dir < 2 ? bit_scan_reverse(mask) : bit_scan(mask);
+    }
+
+    // Свободные клетки луча из s до первой занятой клетки
+    static uint32_t free_ray(const int dir, const int s, const uint32_t occ)
+    {
+        const int b = first_blocker(dir, ray(dir, s) & occ);
+        if (b == -1)
+            return ray(dir, s);
+        return ray(dir, s) & ~ray(dir, b) & ~(1u << b);
+    }
+
+    // Все клетки, куда дамка из s может сходить без взятия
+    static uint32_t queen_steps(const int s, const uint32_t occ)
+    {
+        return free_ray(0, s, occ) | free_ray(1, s, occ) | free_ray(2, s, occ) | free_ray(3, s, occ);
+    }
+
+    // Перебирает клетки маски на луче в порядке удаления от начала луча
+    template <class F> static void for_each_on_ray(const int dir, uint32_t mask, F&& f)
+    {
+        while (mask)
+        {
+            const int l = dir < 2 ? bit_scan_reverse(mask) : bit_scan(mask);
+            mask &= ~(1u << l);
+            f(l);
+        }
+    }
+
+    // Рекурсивно продолжает серию взятий фигуры из клетки s. Побитые фигуры снимаются сразу,
+    // шашка, дошедшая до последней строки, продолжает бить как дамка.
+    static void add_beat_series(const position& pos, const bool color, const int s, bit_move& cur,
+        move_list& moves)
+    {
+        bool can_beat = false;
+        for_each_jump(pos, s, [&](const int b, const int l) {
+            can_beat = true;
+            position next_pos = pos; // Счётчики оценки в промежуточных позициях серии не обновляются
+            const uint32_t from = 1u << s, to = 1u << l, beaten = ~(1u << b);
+            next_pos.white &= beaten;
+            next_pos.black &= beaten;
+            next_pos.kings &= beaten;
+            uint32_t& side = color ? next_pos.black : next_pos.white;
+            side = (side & ~from) | to;
+            const bool promotion = !(next_pos.kings & from) && (((color ? BOTTOM_ROW : TOP_ROW) & to) != 0);
+            if ((next_pos.kings & from) || promotion)
+                next_pos.kings = (next_pos.kings & ~from) | to;
+
+            const bool was_promotion = cur.promotion;
+            cur.path[cur.beats] = int8_t(l);
+            cur.beaten[cur.beats] = int8_t(b);
+            ++cur.beats;
+            cur.captured |= 1u << b;
+            cur.promotion = was_promotion || promotion;
+            add_beat_series(next_pos, color, l, cur, moves);
+            --cur.beats;
+            cur.captured &= ~(1u << b);
+            cur.promotion = was_promotion;
+        });
+        if (!can_beat && cur.beats)
+        {
+            cur.to = int8_t(s);
+            moves.push_back(cur);
+        }
+    }
+};
@@ -0,0 +1,99 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <random>
+#include <string>
+
+#include "../Models/MoveList.h"
+#include "../Models/Position.h"
+#include "MappedFile.h"
+#include "Zobrist.h"
+
+// Ход дебютной книги. Ход задаётся клетками и маской побитых фигур: разные серии взятий с одинаковыми
+// клетками приводят к одной и той же позиции, поэтому для книги это один ход.
+struct book_entry
+{
+    uint64_t key;      // Хеш позиции (Zobrist::hash с учётом очереди хода)
+    uint32_t captured; // Маска побитых фигур
+    int8_t from;       // Индекс начальной клетки
+    int8_t to;         // Индекс конечной клетки
+    uint16_t weight;   // Вес хода: чем больше, тем чаще он выбирается
+};
+
+// Класс OpeningBook - дебютная книга (строится Tools/BookGen.cpp). Записи отсортированы по хешу позиции,
+// поэтому ходы позиции находятся двоичным поиском прямо в отображённом в память файле, без копирования.
+//
+// Формат файла: заголовок (MAGIC, VERSION, количество записей, резерв), затем записи book_entry.
+class OpeningBook
+{
+public:
+    static const uint32_t MAGIC = 0x424F4B43; // "CKOB"
+    static const uint32_t VERSION = 1;
+
+    // Открывает файл книги. Возвращает false, если файла нет или он повреждён.
+    bool load(const std::string& path)
+    {
+        entries = nullptr;
+        count = 0;
+        if (!file.open(path) || file.size() < 16)
+            return false;
+        uint32_t header[4];
+        memcpy(header, file.data(), sizeof(header));
+        if (header[0] != MAGIC || header[1] != VERSION || file.size() != 16 + header[2] * sizeof(book_entry))
+            return false;
+        entries = reinterpret_cast<const book_entry*>(file.data() + 16);
+        count = header[2];
+        return true;
+    }
+
+    // Количество записей в книге
+    size_t size() const
+    {
+        return count;
+    }
+
+    // Выбирает ход из книги случайно с учётом весов. Рассматриваются только ходы из turns,
+    // поэтому повреждённая или чужая книга не может сделать недопустимый ход.
+    // Возвращает номер хода в turns или -1, если позиции нет в книге.
+    template <class Random>
+    int choose(const position& pos, const bool color, const move_list& turns, Random& rand_eng) const
+    {
+        const uint64_t key = Zobrist::hash(pos, color);
+        const book_entry* first = std::lower_bound(entries, entries + count, key,
+            [](const book_entry& e, const uint64_t k) { return e.key < k; });
+        int moves[MAX_MOVES];
+        uint32_t weights[MAX_MOVES];
+        int found = 0;
+        uint32_t total = 0;
+        for (const book_entry* e = first; e != entries + count && e->key == key && found < int(MAX_MOVES); ++e)
+        {
+            for (size_t i = 0; i < turns.size(); ++i)
+            {
+                const bit_move& turn = turns[i];
+                if (turn.from == e->from && turn.to == e->to && turn.captured == e->captured && e->weight)
+                {
+                    moves[found] = int(i);
+                    weights[found++] = e->weight;
+                    total += e->weight;
+                    break;
+                }
+            }
+        }
+        if (!found)
+            return -1;
+        uint32_t r = std::uniform_int_distribution<uint32_t>(0, total - 1)(rand_eng);
+        for (int i = 0; i < found; ++i)
+        {
+            if (r < weights[i])
+                return moves[i];
+            r -= weights[i];
+        }
+        return moves[found - 1];
+    }
+
+private:
+    MappedFile file;
+    const book_entry* entries = nullptr;
+    size_t count = 0;
+};
@@ -0,0 +1,627 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../Models/EvalWeights.h"
+#include "../Models/Move.h"
+#include "../Models/MoveList.h"
+#include "../Models/Position.h"
+#include "../Models/SearchCounters.h"
+#include "FeatureEval.h"
+#include "MoveGen.h"
+#include "Tablebase.h"
+#include "TranspositionTable.h"
+#include "Zobrist.h"
+
+using namespace std;
+
+const double INF = 1e9; // Константа, обозначающая "бесконечность" для алгоритма минимакса
+const int MAX_PLY = 64; // Максимальная глубина поиска
+const int HISTORY_MAX = 1 << 20; // Порог, после которого таблица истории уменьшается вдвое
+const double ASPIRATION_WINDOW = 1.02; // Окно стремления: оценка прошлой итерации, делённая и умноженная на это число
+const int LMR_FULL_TURNS = 3; // Сколько первых ходов узла всегда ищутся на полную глубину
+const int LMR_MIN_REMAINING = 3; // С какой оставшейся глубины поздние тихие ходы ищутся на полуход мельче
+const int FUTILITY_DEPTH = 1; // На какой оставшейся глубине безнадёжные тихие ходы не перебираются
+const double FUTILITY_MARGIN = 1.2; // Во сколько раз тихий ход может улучшить оценку за полуход
+
+// Метод оценки позиции
+enum class Scoring
+{
+    NUMBER_ONLY,         // "NumberOnly" - только количество шашек и дамок
+    NUMBER_AND_POTENTIAL, // "NumberAndPotential" - ещё и продвижение шашек к дамочной строке
+    FEATURES              // "Features" - признаки позиции с обученными весами (см. FeatureEval)
+};
+
+// Уровень оптимизации поиска
+enum class Pruning
+{
+    NONE,      // "O0" - полный перебор без отсечений и таблицы транспозиций
+    ALPHA_BETA // "O1"/"O2" - альфа-бета отсечения и таблица транспозиций
+};
+
+// Настройки бота, общие для всех потоков поиска
+struct search_settings
+{
+    Scoring scoring = Scoring::NUMBER_ONLY; // Метод оценки позиции
+    Pruning pruning = Pruning::ALPHA_BETA; // Уровень оптимизации поиска
+    int time_limit_ms = 0; // Время на ход в миллисекундах (0 - без ограничения)
+    int quiescence_nodes = 64; // Сколько узлов поиска взятий можно раскрыть за каждым листом (0 - не искать)
+    bool late_move_reductions = true; // Искать поздние тихие ходы на полуход мельче
+    bool futility_pruning = true; // Не перебирать рядом с листьями тихие ходы, которые не догонят alpha
+    const Tablebase* tablebase = nullptr; // Таблицы окончаний (nullptr - не используются)
+    const FeatureEval* features = nullptr; // Веса метода "Features" (nullptr - обученные по умолчанию)
+};
+
+// Ход поиска для показа пользователю: пишет главный поток, читать можно из любого потока
+struct search_progress
+{
+    atomic<int> depth{ -1 };   // Глубина последней завершённой итерации
+    atomic<size_t> nodes{ 0 }; // Количество узлов, просмотренных главным потоком
+};
+
+// Класс Search - поиск одного потока. У каждого потока свои таблица истории, ходы-убийцы, главная линия
+// и генератор случайных чисел; общие у потоков только таблица транспозиций и флаг остановки.
+class Search
+{
+public:
+    explicit Search(const unsigned seed = 0) : rand_eng(seed)
+    {
+        pv_table.assign(MAX_PLY + 1, vector<bit_move>(MAX_PLY + 1));
+        pv_length.assign(MAX_PLY + 1, 0);
+        killers.assign(MAX_PLY + 1, array<bit_move, 2>());
+        move_lists.resize(MAX_PLY + 1);
+    }
+
+    // Итеративное углубление от глубины start_depth до max_depth.
+    // За временем следит только главный поток (main): когда время выходит, он поднимает флаг stop,
+    // а остальные потоки прерываются по этому флагу.
+    void iterate(const position& pos, const bool color, const int start_depth, const int max_depth, const bool main,
+        TranspositionTable* table, const search_settings* search_config, atomic<bool>* stop,
+        const chrono::steady_clock::time_point start)
+    {
+        tt = table;
+        settings = search_config;
+        stop_flag = stop;
+        search_start = start;
+        is_main = main;
+        stopped = false;
+        nodes = 0;
+        completed_depth = -1;
+        best_move = bit_move();
+        counters.clear();
+        prev_pv.clear();
+        for (auto& ply_killers : killers)
+            ply_killers[0] = ply_killers[1] = bit_move();
+        age_history();
+        // Ядро поиска выбирается один раз: для каждого сочетания оценки и оптимизации компилируется своя версия
+        if (settings->pruning == Pruning::ALPHA_BETA)
+            deepen<Pruning::ALPHA_BETA>(settings->scoring, pos, color, start_depth, max_depth);
+        else
+            deepen<Pruning::NONE>(settings->scoring, pos, color, start_depth, max_depth);
+    }
+
+    // Выбирает версию итераций углубления для метода оценки scoring
+    template <Pruning P>
+    void deepen(const Scoring scoring, const position& pos, const bool color, const int start_depth,
+        const int max_depth)
+    {
+        if (scoring == Scoring::FEATURES)
+            deepen<Scoring::FEATURES, P>(pos, color, start_depth, max_depth);
+        else if (scoring == Scoring::NUMBER_AND_POTENTIAL)
+            deepen<Scoring::NUMBER_AND_POTENTIAL, P>(pos, color, start_depth, max_depth);
+        else
+            deepen<Scoring::NUMBER_ONLY, P>(pos, color, start_depth, max_depth);
+    }
+
+    // Итерации углубления для выбранных метода оценки S и уровня оптимизации P
+    // Корень ищется с окном стремления вокруг оценки прошлой итерации: оценка - отношение материала, поэтому
+    // окно задаётся множителем. Если оценка вышла за окно, итерация повторяется с полным окном.
+    template <Scoring S, Pruning P>
+    void deepen(const position& pos, const bool color, const int start_depth, const int max_depth)
+    {
+        double prev_score = -INF; // Оценка прошлой итерации (-INF - её нет)
+        for (iteration_depth = start_depth; iteration_depth <= max_depth; ++iteration_depth)
+        {
+            double alpha = -INF, beta = INF;
+            if (P != Pruning::NONE && prev_score > 0 && prev_score < INF)
+            {
+                alpha = prev_score / ASPIRATION_WINDOW;
+                beta = prev_score * ASPIRATION_WINDOW;
+            }
+            double score = find_first_best_turn<S, P>(pos, color, alpha, beta);
+            if (!stopped && (score <= alpha || score >= beta) && (alpha > -INF || beta < INF))
+                score = find_first_best_turn<S, P>(pos, color, -INF, INF);
+            if (stopped) // Итерация прервана, её результат не используется
+                break;
+            prev_score = score;
+            best_move = next_move;
+            completed_depth = iteration_depth;
+            if (is_main && progress)
+                progress->depth.store(completed_depth, memory_order_relaxed);
+            if (search_counters::enabled)
+                counters.iteration(iteration_depth, nodes,
+                    chrono::duration<double, milli>(chrono::steady_clock::now() - search_start).count());
+            // Главная линия этой итерации просматривается первой на следующей
+            prev_pv.assign(pv_table[0].begin(), pv_table[0].begin() + pv_length[0]);
+            if (score >= INF) // Выигрыш найден
+                break;
+            if (is_main && settings->time_limit_ms && elapsed_ms() >= settings->time_limit_ms) // Время вышло
+                break;
+        }
+    }
+
+    // Функция ищет лучший первый ход для бота на глубину iteration_depth в окне (alpha, beta).
+    // Серия взятий считается одним ходом, поэтому корень перебирает ходы целиком.
+    // Ходит бот, поэтому оценка корня - оценка с точки зрения бота.
+    template <Scoring S, Pruning P>
+    double find_first_best_turn(const position& pos, const bool color, double alpha, const double beta)
+    {
+        next_move = bit_move(); // Сбрасываем лучший ход
+        bot_color = color;
+        follow_pv = true;
+        pv_length[0] = 0;
+        const double alpha_start = alpha;
+        double best_score = -INF; // Инициализируем наихудший возможный счёт
+
+        move_list& turns_now = move_lists[0];
+        find_turns(color, pos, turns_now);
+        order_turns<P>(pos, color, 0, turns_now);
+
+        // Перебираем все возможные ходы
+        for (const auto& turn : turns_now)
+        {
+            counters.chain(turn.beats);
+            // Передаём ход противнику
+            const double score = search_turn<S, P>(make_turn(pos, turn, color), !color, 0,
+                &turn == turns_now.begin(), alpha, beta);
+            if (stopped)
+                return best_score;
+            // Если ход лучше предыдущего, обновляем лучшую оценку и лучший ход
+            if (score > best_score)
+            {
+                best_score = score;
+                next_move = turn;
+                update_pv(0, turn);
+            }
+            alpha = max(alpha, best_score);
+            if (P != Pruning::NONE && alpha >= beta) // Оценка выше окна стремления
+                break;
+        }
+        if (use_tt<P>() && next_move.from != -1)
+        {
+            const Bound bound =
+                best_score <= alpha_start ? Bound::UPPER : (best_score >= beta ? Bound::LOWER : Bound::EXACT);
+            tt->store(pos.hash, iteration_depth + 1, best_score, bound, &next_move);
+        }
+        return best_score; // Возвращаем оценку лучшего найденного хода
+    }
+
+    // Поиск хода, который уже сделан в позиции pos (ходит color), для узла с окном (alpha, beta).
+    // Первый ход узла ищется с полным окном. Остальные сначала проверяются нулевым окном: нужно лишь узнать,
+    // лучше ли ход, чем alpha. Полным окном ход ищется повторно, только если он оказался лучше.
+    // Возвращает оценку хода с точки зрения стороны, которая его сделала.
+    template <Scoring S, Pruning P>
+    double search_turn(const position& pos, const bool color, const size_t depth, const bool first,
+        const double alpha, const double beta)
+    {
+        if (P == Pruning::NONE || first)
+            return -find_best_turns_rec<S, P>(pos, color, depth, -beta, -alpha);
+        const double score = -find_best_turns_rec<S, P>(pos, color, depth, -nextafter(alpha, INF), -alpha);
+        if (score > alpha && score < beta && !stopped)
+            return -find_best_turns_rec<S, P>(pos, color, depth, -beta, -alpha);
+        return score;
+    }
+
+    // Рекурсивная функция поиска negamax с альфа-бета отсечением.
+    // Оценка узла берётся с точки зрения стороны, которая ходит: для бота это оценка calc_score, для противника -
+    // она же со знаком минус. Поэтому оценка узла - максимум оценок ходов, а окно ребёнка - (-beta, -alpha).
+    // color - чей ход (0 - белые, 1 - чёрные)
+    // depth - текущая глубина поиска (на чётной глубине ходит противник, на нечётной - бот)
+    template <Scoring S, Pruning P>
+    double find_best_turns_rec(const position& pos, const bool color, const size_t depth, double alpha,
+        const double beta)
+    {
+        const int ply = int(depth) + 1; // Расстояние от корня
+        pv_length[ply] = 0;
+        // Решённое окончание не перебираем: результат берётся из таблиц окончаний
+        double tb_score;
+        if (probe_tablebase(pos, color, tb_score))
+            return side_score(color, tb_score);
+        if (depth >= size_t(iteration_depth)) // Если достигли максимальной глубины, оцениваем позицию с точки зрения бота
+        {
+            int budget = settings->quiescence_nodes;
+            return quiesce<S, P>(pos, color, depth, alpha, beta, budget);
+        }
+        if (time_is_over())
+            return 0;
+
+        // Если позиция уже оценена на достаточной глубине, используем сохранённую оценку
+        const int remaining = iteration_depth - int(depth);
+        tt_entry entry;
+        const bool tt_hit = use_tt<P>() && tt->probe(pos.hash, entry);
+        if (use_tt<P>())
+            counters.tt_probe(tt_hit);
+        if (tt_hit && entry.depth >= remaining)
+        {
+            if (entry.bound == Bound::EXACT || (entry.bound == Bound::LOWER && entry.score >= beta) ||
+                (entry.bound == Bound::UPPER && entry.score <= alpha))
+                return entry.score;
+        }
+
+        // Ищем все возможные ходы для игрока (серии взятий целиком)
+        move_list& turns_now = move_lists[ply];
+        find_turns(color, pos, turns_now);
+
+        if (turns_now.empty()) // Если ходов нет, значит это проигрыш
+        {
+            return side_score(color, color == bot_color ? 0 : INF);
+        }
+        order_turns<P>(pos, color, ply, turns_now);
+
+        const double alpha_start = alpha;
+        double best_score = -INF; // Наилучшая найденная оценка
+        const bit_move* best_turn = nullptr;
+        // Оценка, которой тихий ход не превысит даже с запасом: считается только рядом с листьями
+        const bool futility = P != Pruning::NONE && settings->futility_pruning && remaining <= FUTILITY_DEPTH;
+        const double futility_score = futility ? optimistic_score<S>(pos, color, remaining) : INF;
+
+        // Перебираем все возможные ходы
+        for (const auto& turn : turns_now)
+        {
+            counters.chain(turn.beats);
+            const size_t index = size_t(&turn - turns_now.begin());
+            const bool quiet = !turn.beats && !turn.promotion;
+            // Тихий ход рядом с листьями, который не догонит alpha даже с запасом, не перебираем
+            if (quiet && index > 0 && futility_score <= alpha)
+            {
+                best_score = max(best_score, futility_score);
+                continue;
+            }
+            // Выполняем ход и передаём ход противнику
+            const position next = make_turn(pos, turn, color);
+            double score;
+            if (quiet && settings->late_move_reductions && P != Pruning::NONE && index >= size_t(LMR_FULL_TURNS) &&
+                remaining >= LMR_MIN_REMAINING)
+            {
+                // Поздний тихий ход сначала ищется на полуход мельче нулевым окном. Полная глубина нужна, только
+                // если он оказался лучше alpha.
+                score = -find_best_turns_rec<S, P>(next, !color, depth + 2, -nextafter(alpha, INF), -alpha);
+                pv_length[ply + 1] = 0; // Главная линия сокращённого поиска лежит на полуход дальше
+                if (score > alpha && !stopped)
+                    score = search_turn<S, P>(next, !color, depth + 1, false, alpha, beta);
+            }
+            else
+                score = search_turn<S, P>(next, !color, depth + 1, index == 0, alpha, beta);
+            if (stopped) // Поиск прерван, оценки этой итерации недостоверны
+                return 0;
+
+            if (score > best_score)
+            {
+                best_score = score;
+                best_turn = &turn;
+                update_pv(ply, turn);
+            }
+            alpha = max(alpha, best_score);
+
+            // Если нашли достаточно хороший ход, прерываем дальнейший поиск
+            if (P != Pruning::NONE && alpha >= beta)
+            {
+                counters.cutoff(index);
+                add_cutoff(color, ply, turn, remaining);
+                break;
+            }
+        }
+
+        if (use_tt<P>())
+        {
+            const Bound bound =
+                best_score <= alpha_start ? Bound::UPPER : (best_score >= beta ? Bound::LOWER : Bound::EXACT);
+            tt->store(pos.hash, remaining, best_score, bound, best_turn);
+        }
+        return best_score;
+    }
+
+    // Поиск взятий за горизонтом. Взятие обязательно, поэтому позиция, в которой сторона должна бить,
+    // оценивается только после того, как все взятия сделаны: иначе бот не видит, что сразу за горизонтом
+    // теряет фигуру. Перебираются только взятия. budget - сколько ещё узлов можно раскрыть за листом
+    // основного поиска; когда он исчерпан, позиция оценивается как есть.
+    template <Scoring S, Pruning P>
+    double quiesce(const position& pos, const bool color, const size_t depth, double alpha, double beta, int& budget)
+    {
+        const int ply = int(depth) + 1;
+        if (budget <= 0 || ply >= MAX_PLY || !MoveGen::capturers(pos, color))
+        {
+            counters.leaf();
+            return side_score(color, evaluate<S>(pos));
+        }
+        if (time_is_over())
+            return 0;
+        --budget;
+        counters.qnode();
+
+        move_list& turns_now = move_lists[ply];
+        MoveGen::generate(pos, color, turns_now);
+        double best = -INF;
+        for (const auto& turn : turns_now)
+        {
+            // Хеш за горизонтом не нужен: таблица транспозиций здесь не используется
+            const position next = MoveGen::make_move(pos, turn, color);
+            double score;
+            if (probe_tablebase(next, !color, score))
+                score = side_score(color, score);
+            else
+                score = -quiesce<S, P>(next, !color, depth + 1, -beta, -alpha, budget);
+            if (stopped)
+                return 0;
+            best = max(best, score);
+            alpha = max(alpha, best);
+            if (P != Pruning::NONE && alpha >= beta)
+                break;
+        }
+        return best;
+    }
+
+private:
+    // Наилучшая оценка (с точки зрения стороны color), которой тихий ход может достичь за remaining полуходов:
+    // тихий ход не меняет материал, поэтому это оценка позиции, улучшенная в FUTILITY_MARGIN раз на каждый полуход
+    template <Scoring S> double optimistic_score(const position& pos, const bool color, const int remaining) const
+    {
+        double margin = 1;
+        for (int i = 0; i < remaining; ++i)
+            margin *= FUTILITY_MARGIN;
+        const double score = evaluate<S>(pos);
+        return color == bot_color ? score * margin : -score / margin;
+    }
+
+    // Оценка позиции с точки зрения бота методом S
+    template <Scoring S> double evaluate(const position& pos) const
+    {
+        if (S != Scoring::FEATURES)
+            return calc_score<S>(pos, bot_color);
+        static const FeatureEval trained;
+        return (settings->features ? *settings->features : trained).score(pos, bot_color, INF);
+    }
+
+    // Переводит оценку с точки зрения бота в оценку с точки зрения стороны color
+    double side_score(const bool color, const double score) const
+    {
+        return color == bot_color ? score : -score;
+    }
+
+    // Оценка позиции по таблицам окончаний с точки зрения бота. Возвращает false, если позиции в таблицах нет.
+    bool probe_tablebase(const position& pos, const bool color, double& score) const
+    {
+        tb_value tb;
+        if (!settings->tablebase || !settings->tablebase->probe(pos, color, tb))
+            return false;
+        if (tb.result == TbResult::DRAW)
+            score = 1; // Как при равном материале
+        else
+            score = (tb.result == TbResult::WIN) == (color == bot_color) ? INF : 0;
+        return true;
+    }
+
+    // Функция выполняет виртуальный ход (вместе со всей серией взятий) и возвращает новую позицию после этого хода
+    // Хеш позиции обновляется по изменившимся клеткам.
+    position make_turn(const position& pos, const bit_move& turn, const bool color) const
+    {
+        position res = MoveGen::make_move(pos, turn, color);
+        const int type = pos.piece(turn.from);
+        res.hash = pos.hash ^ Zobrist::black_to_move() ^ Zobrist::piece(type, turn.from) ^
+            Zobrist::piece(turn.promotion ? type + 2 : type, turn.to);
+        for (uint32_t beaten = turn.captured; beaten; beaten &= beaten - 1)
+        {
+            const int s = bit_scan(beaten);
+            res.hash ^= Zobrist::piece(pos.piece(s), s);
+        }
+        return res;
+    }
+
+    // Использовать ли таблицу транспозиций (O0 - полный перебор без оптимизаций)
+    template <Pruning P> static constexpr bool use_tt()
+    {
+        return P != Pruning::NONE;
+    }
+
+    // Находит все ходы цвета color для поиска: каждая серия взятий - один ход
+    void find_turns(const bool color, const position& pos, move_list& res_turns)
+    {
+        MoveGen::generate(pos, color, res_turns);
+        shuffle(res_turns.begin(), res_turns.end(), rand_eng); // Перемешиваем ходы (если активирован случайный порядок)
+    }
+
+    // Упорядочивает ходы перед перебором. Ходы уже перемешаны, а сортировка устойчивая, поэтому
+    // случайность решает только между ходами с одинаковым приоритетом. Порядок приоритетов:
+    // ход главной линии прошлой итерации, ход из таблицы транспозиций, превращения в дамку и длинные
+    // серии взятий, ходы-убийцы этой глубины, затем ходы по таблице истории отсечений.
+    template <Pruning P> void order_turns(const position& pos, const bool color, const int ply, move_list& turns_now)
+    {
+        // Узел лежит на главной линии прошлой итерации, только пока по ней идёт первый ход каждого узла
+        const bit_move* pv_turn = nullptr;
+        if (follow_pv && ply < int(prev_pv.size()))
+        {
+            for (const auto& turn : turns_now)
+            {
+                if (turn == prev_pv[ply])
+                    pv_turn = &turn;
+            }
+        }
+        follow_pv = pv_turn != nullptr;
+        tt_entry entry;
+        const bool tt_move = use_tt<P>() && tt->probe(pos.hash, entry) && entry.from != -1;
+
+        int priority_buf[MAX_MOVES];
+        vector<int> priority_spill; // Для списков, переехавших в кучу (см. move_list)
+        int* priority = priority_buf;
+        if (turns_now.size() > MAX_MOVES)
+        {
+            priority_spill.resize(turns_now.size());
+            priority = priority_spill.data();
+        }
+        for (size_t i = 0; i < turns_now.size(); ++i)
+        {
+            const bit_move& turn = turns_now[i];
+            if (&turn == pv_turn)
+                priority[i] = 1 << 30;
+            else if (tt_move && entry.is_best(turn))
+                priority[i] = 1 << 29;
+            else if (turn.beats || turn.promotion)
+                priority[i] = (1 << 26) + (turn.promotion << 20) + (turn.beats << 16);
+            else if (turn == killers[ply][0])
+                priority[i] = (1 << 25) + 1;
+            else if (turn == killers[ply][1])
+                priority[i] = 1 << 25;
+            else
+                priority[i] = history[color][turn.from][turn.to];
+        }
+        // Сортировка вставками: ходов мало, и она сохраняет порядок равных
+        for (size_t i = 1; i < turns_now.size(); ++i)
+        {
+            const bit_move turn = turns_now[i];
+            const int p = priority[i];
+            size_t j = i;
+            for (; j > 0 && priority[j - 1] < p; --j)
+            {
+                turns_now[j] = turns_now[j - 1];
+                priority[j] = priority[j - 1];
+            }
+            turns_now[j] = turn;
+            priority[j] = p;
+        }
+    }
+
+    // Запоминает тихий ход, вызвавший отсечение: он становится ходом-убийцей для этой глубины
+    // и поднимается в таблице истории тем сильнее, чем больше оставшаяся глубина
+    void add_cutoff(const bool color, const int ply, const bit_move& turn, const int remaining)
+    {
+        if (turn.beats || turn.promotion)
+            return;
+        if (turn != killers[ply][0])
+        {
+            killers[ply][1] = killers[ply][0];
+            killers[ply][0] = turn;
+        }
+        int& value = history[color][turn.from][turn.to];
+        value += remaining * remaining;
+        if (value >= HISTORY_MAX)
+            age_history();
+    }
+
+    // Уменьшает вдвое все значения истории, чтобы старые отсечения весили меньше новых
+    void age_history()
+    {
+        for (auto& side : history)
+            for (auto& from : side)
+                for (auto& value : from)
+                    value /= 2;
+    }
+
+    // Запоминает новый лучший ход узла на расстоянии ply от корня и продолжение главной линии из дочернего узла
+    void update_pv(const int ply, const bit_move& turn)
+    {
+        pv_table[ply][0] = turn;
+        for (int i = 0; i < pv_length[ply + 1]; ++i)
+            pv_table[ply][i + 1] = pv_table[ply + 1][i];
+        pv_length[ply] = pv_length[ply + 1] + 1;
+    }
+
+    // Время, прошедшее с начала поиска, в миллисекундах
+    int elapsed_ms() const
+    {
+        return int(chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - search_start).count());
+    }
+
+    // Проверяет, не пора ли остановить поиск. Первая итерация всегда доводится до конца, чтобы был ход.
+    bool time_is_over()
+    {
+        if (stopped)
+            return true;
+        ++nodes;
+        if (iteration_depth == 0)
+            return false;
+        if (stop_flag->load(memory_order_relaxed)) // Поиск остановлен другим потоком
+            return stopped = true;
+        if (!is_main || (nodes & 1023) != 0)
+            return false;
+        if (progress)
+            progress->nodes.store(nodes, memory_order_relaxed);
+        if (settings->time_limit_ms && elapsed_ms() >= settings->time_limit_ms)
+        {
+            stopped = true;
+            stop_flag->store(true, memory_order_relaxed);
+        }
+        return stopped;
+    }
+
+public:
+    // Функция оценивает текущее состояние доски и возвращает числовой показатель (чем выше, тем лучше для бота).
+    // Так оцениваются методы "NumberOnly" и "NumberAndPotential"; метод "Features" оценивает FeatureEval::score.
+    // Количество фигур и продвижение шашек хранятся в позиции и обновляются при каждом ходе, поэтому
+    // оценка не перебирает клетки доски.
+    template <Scoring S> static double calc_score(const position& pos, const bool first_bot_color)
+    {
+        // color - определяет, кто является максимизирующим игроком (бот или противник)
+        int w = pos.pieces[0], b = pos.pieces[1]; // Количество белых и чёрных шашек
+        int wq = pos.pieces[2], bq = pos.pieces[3]; // Количество белых и чёрных дамок
+        int wa = pos.advance[0], ba = pos.advance[1]; // Продвижение белых и чёрных шашек
+        // Если бот играет за чёрных, меняем местами значения
+        if (!first_bot_color)
+        {
+            swap(b, w);
+            swap(bq, wq);
+            swap(ba, wa);
+        }
+        // Если у бота не осталось фигур, это поражение (возвращаем "бесконечность")
+        if (w + wq == 0)
+            return INF;
+        // Если у противника не осталось фигур, это победа (возвращаем 0)
+        if (b + bq == 0)
+            return 0;
+        // Оцениваем силу позиций: чем выше значение, тем выгоднее текущая позиция для бота.
+        // Дамка стоит 4 шашки. Если используется метод "NumberAndPotential", дамка стоит 5 шашек и учитывается
+        // "потенциал" шашек: 0.05 за каждую строку продвижения к дамке. Числитель и знаменатель считаются
+        // в целых (в двадцатых долях шашки), поэтому равные позиции получают в точности равные оценки.
+        const eval_weights k = score_weights<S>();
+        return double(k.man * b + k.advance * ba + k.king * bq) / double(k.man * w + k.advance * wa + k.king * wq);
+    }
+
+    // Веса материала метода оценки S. С этими весами BatchEval::evaluate оценивает пачку позиций так же,
+    // как calc_score каждую по отдельности.
+    template <Scoring S> static eval_weights score_weights()
+    {
+        if (S == Scoring::NUMBER_AND_POTENTIAL)
+            return eval_weights{ 20, 100, 1 };
+        return eval_weights{ 1, 4, 0 };
+    }
+
+    bit_move best_move; // Лучший ход последней завершённой итерации
+    int completed_depth = -1; // Глубина последней завершённой итерации (-1 - ни одной)
+    size_t nodes = 0; // Счётчик внутренних узлов поиска (по нему же время проверяется раз в 1024 узла)
+    search_progress* progress = nullptr; // Куда главный поток сообщает о ходе поиска (nullptr - никуда)
+    search_counters counters; // Счётчики последнего поиска (только при сборке с CHECKERS_STATS)
+
+private:
+    default_random_engine rand_eng; // Генератор случайных чисел (для случайного порядка равноценных ходов)
+    TranspositionTable* tt = nullptr; // Таблица транспозиций, общая для всех потоков
+    const search_settings* settings = nullptr; // Настройки бота
+    atomic<bool>* stop_flag = nullptr; // Общий флаг остановки поиска
+    chrono::steady_clock::time_point search_start; // Время начала поиска
+    bool is_main = true; // Главный поток (следит за временем на ход)
+    bit_move next_move;  // Лучший ход, найденный в корне текущей итерации
+    bool bot_color = false; // Цвет бота в текущем поиске (оценки считаются с его точки зрения)
+    int iteration_depth = 0; // Глубина текущей итерации углубления
+    bool stopped = false; // Поиск этого потока прерван
+    vector<vector<bit_move>> pv_table; // Главные линии из каждого узла текущего пути (треугольная таблица)
+    vector<int> pv_length; // Длины главных линий в pv_table
+    vector<bit_move> prev_pv; // Главная линия прошлой итерации
+    bool follow_pv = false; // Идёт ли поиск по главной линии прошлой итерации
+    vector<move_list> move_lists; // Списки ходов для каждого расстояния от корня: во время поиска память не выделяется
+    vector<array<bit_move, 2>> killers; // Два последних тихих хода, вызвавших отсечение, для каждой глубины
+    int history[2][32][32] = {}; // Таблица истории: вес тихих ходов [цвет][откуда][куда] по отсечениям
+};
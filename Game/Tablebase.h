@@ -0,0 +1,261 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <string>
+
+#include "../Models/MoveList.h"
+#include "../Models/Position.h"
+#include "MappedFile.h"
+#include "MoveGen.h"
+
+// Результат позиции по таблицам окончаний для стороны, которая ходит
+enum class TbResult : uint8_t
+{
+    DRAW,
+    WIN,
+    LOSS
+};
+
+// Значение позиции: результат и число полуходов до конца партии при лучшей игре обеих сторон
+struct tb_value
+{
+    TbResult result = TbResult::DRAW;
+    int distance = 0;
+};
+
+// Класс Tablebase - таблицы окончаний для позиций с небольшим числом фигур (строятся Tools/TablebaseGen.cpp).
+// Для каждого сочетания фигур (материала) хранится по байту на позицию. Позиция внутри материала нумеруется
+// сочетаниями: отдельно для белых дамок, чёрных дамок, белых шашек и чёрных шашек, младший бит - чей ход.
+// Файл отображается в память, поэтому загрузка ничего не читает заранее.
+//
+// Формат файла: заголовок (MAGIC, VERSION, максимальное число фигур, число материалов),
+// затем для каждого материала (ключ, смещение, размер), затем сами таблицы.
+class Tablebase
+{
+public:
+    static const uint32_t MAGIC = 0x42544B43; // "CKTB"
+    static const uint32_t VERSION = 1;
+    static const int MAX_PIECES = 7; // Больше фигур одного вида ключ материала не вмещает
+
+    // Заголовок материала в файле
+    struct material_header
+    {
+        uint32_t key;
+        uint32_t reserved;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    // Значение в байт: 0 - ничья, 1..127 - выигрыш за столько полуходов, 128 + d - проигрыш через d полуходов
+    static uint8_t encode(const tb_value& value)
+    {
+        if (value.result == TbResult::WIN)
+            return uint8_t(value.distance);
+        if (value.result == TbResult::LOSS)
+            return uint8_t(128 + value.distance);
+        return 0;
+    }
+    static tb_value decode(const uint8_t code)
+    {
+        tb_value value;
+        if (code >= 128)
+        {
+            value.result = TbResult::LOSS;
+            value.distance = code - 128;
+        }
+        else if (code)
+        {
+            value.result = TbResult::WIN;
+            value.distance = code;
+        }
+        return value;
+    }
+
+    // Ключ материала по количеству белых шашек, чёрных шашек, белых дамок и чёрных дамок
+    static int material_key(const int wm, const int bm, const int wk, const int bk)
+    {
+        return ((wm * 8 + bm) * 8 + wk) * 8 + bk;
+    }
+    static int material_key(const position& pos)
+    {
+        return material_key(bit_count(pos.white & ~pos.kings), bit_count(pos.black & ~pos.kings),
+            bit_count(pos.white & pos.kings), bit_count(pos.black & pos.kings));
+    }
+
+    // Количество записей в таблице материала (включая невозможные расстановки)
+    static uint64_t material_size(const int key)
+    {
+        return binomial(32, key >> 9) * binomial(32, (key >> 6) & 7) * binomial(32, (key >> 3) & 7) *
+            binomial(32, key & 7) * 2;
+    }
+
+    // Номер позиции в таблице её материала
+    static uint64_t index(const position& pos, const bool color)
+    {
+        const uint32_t groups[4] = { pos.white & pos.kings, pos.black & pos.kings, pos.white & ~pos.kings,
+            pos.black & ~pos.kings };
+        uint64_t idx = 0;
+        for (const uint32_t group : groups)
+            idx = idx * binomial(32, bit_count(group)) + rank(group);
+        return idx * 2 + (color ? 1 : 0);
+    }
+
+    // Позиция по номеру в таблице материала. Возвращает false для невозможной расстановки
+    // (фигуры в одной клетке или шашка на своей строке превращения).
+    static bool position_at(const int key, uint64_t idx, position& pos, bool& color)
+    {
+        const int counts[4] = { (key >> 3) & 7, key & 7, key >> 9, (key >> 6) & 7 }; // wk, bk, wm, bm
+        uint32_t groups[4];
+        color = idx & 1;
+        idx /= 2;
+        for (int g = 3; g >= 0; --g)
+        {
+            const uint64_t size = binomial(32, counts[g]);
+            groups[g] = unrank(idx % size, counts[g]);
+            idx /= size;
+        }
+        const uint32_t wk = groups[0], bk = groups[1], wm = groups[2], bm = groups[3];
+        if ((wk & bk) || ((wk | bk) & (wm | bm)) || (wm & bm))
+            return false;
+        if ((wm & 0x0000000Fu) || (bm & 0xF0000000u)) // Шашка на строке превращения уже была бы дамкой
+            return false;
+        pos = position();
+        for (uint32_t b = wm; b; b &= b - 1)
+            pos.set(position::row(bit_scan(b)), position::col(bit_scan(b)), 1);
+        for (uint32_t b = bm; b; b &= b - 1)
+            pos.set(position::row(bit_scan(b)), position::col(bit_scan(b)), 2);
+        for (uint32_t b = wk; b; b &= b - 1)
+            pos.set(position::row(bit_scan(b)), position::col(bit_scan(b)), 3);
+        for (uint32_t b = bk; b; b &= b - 1)
+            pos.set(position::row(bit_scan(b)), position::col(bit_scan(b)), 4);
+        return true;
+    }
+
+    // Открывает файл таблиц. Возвращает false, если файла нет или он повреждён.
+    bool load(const std::string& path)
+    {
+        pieces = 0;
+        memset(tables, 0, sizeof(tables));
+        if (!file.open(path) || file.size() < 16)
+            return false;
+        const uint8_t* data = file.data();
+        uint32_t header[4];
+        memcpy(header, data, sizeof(header));
+        if (header[0] != MAGIC || header[1] != VERSION || file.size() < 16 + header[3] * sizeof(material_header))
+            return false;
+        for (uint32_t i = 0; i < header[3]; ++i)
+        {
+            material_header m;
+            memcpy(&m, data + 16 + i * sizeof(material_header), sizeof(m));
+            if (m.key >= 4096 || m.offset + m.size > file.size() || m.size != material_size(int(m.key)))
+                return false;
+            tables[m.key] = data + m.offset;
+        }
+        pieces = int(header[2]);
+        return true;
+    }
+
+    // Максимальное число фигур в таблицах (0 - таблицы не загружены)
+    int max_pieces() const
+    {
+        return pieces;
+    }
+
+    // Значение позиции для стороны color. Возвращает false, если позиции нет в таблицах.
+    bool probe(const position& pos, const bool color, tb_value& value) const
+    {
+        if (bit_count(pos.occupied()) > pieces)
+            return false;
+        if (!(color ? pos.black : pos.white)) // Фигур не осталось - партия проиграна
+        {
+            value.result = TbResult::LOSS;
+            value.distance = 0;
+            return true;
+        }
+        if (!(color ? pos.white : pos.black))
+            return false;
+        const uint8_t* table = tables[material_key(pos)];
+        if (!table)
+            return false;
+        value = decode(table[index(pos, color)]);
+        return true;
+    }
+
+    // Лучший ход по таблицам: самый быстрый выигрыш, иначе ничья, иначе самый долгий проигрыш.
+    // Возвращает номер хода в moves или -1, если позиции нет в таблицах.
+    int best_move(const position& pos, const bool color, const move_list& moves) const
+    {
+        int best = -1, best_rank = 0;
+        for (size_t i = 0; i < moves.size(); ++i)
+        {
+            tb_value value;
+            if (!probe(MoveGen::make_move(pos, moves[i], color), !color, value))
+                return -1;
+            // Чем больше rank, тем лучше ход для color
+            int rank = 0;
+            if (value.result == TbResult::LOSS)
+                rank = 1000 - value.distance;
+            else if (value.result == TbResult::WIN)
+                rank = -1000 + value.distance;
+            if (best == -1 || rank > best_rank)
+            {
+                best = int(i);
+                best_rank = rank;
+            }
+        }
+        return best;
+    }
+
+private:
+    // Биномиальный коэффициент C(n, k) для n <= 32
+    static uint64_t binomial(const int n, const int k)
+    {
+        static const binomial_table t = build_binomials();
+        return k < 0 || k > n ? 0 : t.c[n][k];
+    }
+
+    struct binomial_table
+    {
+        uint64_t c[33][33];
+    };
+    static binomial_table build_binomials()
+    {
+        binomial_table t = {};
+        for (int n = 0; n <= 32; ++n)
+        {
+            t.c[n][0] = 1;
+            for (int k = 1; k <= n; ++k)
+                t.c[n][k] = t.c[n - 1][k - 1] + (k <= n - 1 ? t.c[n - 1][k] : 0);
+        }
+        return t;
+    }
+
+    // Номер набора клеток среди всех наборов того же размера
+    static uint64_t rank(uint32_t group)
+    {
+        uint64_t r = 0;
+        for (int i = 1; group; group &= group - 1, ++i)
+            r += binomial(bit_scan(group), i);
+        return r;
+    }
+
+    // Набор из k клеток по его номеру
+    static uint32_t unrank(uint64_t r, const int k)
+    {
+        uint32_t group = 0;
+        int s = 32;
+        for (int i = k; i >= 1; --i)
+        {
+            do
+                --s;
+            while (binomial(s, i) > r);
+            r -= binomial(s, i);
+            group |= 1u << s;
+        }
+        return group;
+    }
+
+    MappedFile file;
+    int pieces = 0;
+    const uint8_t* tables[4096] = {}; // Таблицы материалов по ключу (nullptr - материала нет в файле)
+};
@@ -0,0 +1,118 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <memory>
+
+#include "../Models/Move.h"
+
+// Тип оценки, сохранённой в таблице
+enum class Bound : uint8_t
+{
+    EXACT, // Точная оценка
+    LOWER, // Оценка не меньше сохранённой (было отсечение по beta)
+    UPPER  // Оценка не больше сохранённой (ни один ход не превысил alpha)
+};
+
+// Запись таблицы транспозиций
+struct tt_entry
+{
+    uint64_t key = 0;         // Полный хеш позиции (для проверки коллизий)
+    double score = 0;         // Оценка позиции
+    uint32_t captured = 0;    // Лучший ход: маска побитых фигур
+    int8_t from = -1, to = -1; // Лучший ход: начальная и конечная клетки
+    int8_t depth = -1;        // Оставшаяся глубина, на которой получена оценка
+    Bound bound = Bound::EXACT;
+
+    // Совпадает ли ход с сохранённым лучшим ходом (ходы с одинаковыми клетками и взятиями ведут в одну позицию)
+    bool is_best(const bit_move& turn) const
+    {
+        return turn.from == from && turn.to == to && turn.captured == captured;
+    }
+};
+
+// Класс TranspositionTable - таблица транспозиций фиксированного размера с индексом по хешу Zobrist.
+// Таблица общая для всех потоков поиска и работает без блокировок: запись хранится в двух словах данных,
+// а вместо ключа хранится ключ XOR оба слова. Если запись прочитана во время её перезаписи другим потоком,
+// проверка ключа не сойдётся и запись будет считаться отсутствующей.
+class TranspositionTable
+{
+public:
+    TranspositionTable() = default;
+    // size_mb - размер таблицы в мегабайтах (округляется вниз до степени двойки записей)
+    explicit TranspositionTable(const size_t size_mb)
+    {
+        if (!size_mb)
+            return;
+        size_t count = 1;
+        while (count * 2 * sizeof(tt_slot) <= size_mb * 1024 * 1024)
+            count *= 2;
+        slots.reset(new tt_slot[count]);
+        size = count;
+        mask = count - 1;
+    }
+
+    // Читает запись для позиции. Возвращает false, если позиции нет в таблице.
+    bool probe(const uint64_t key, tt_entry& entry) const
+    {
+        if (!size)
+            return false;
+        const tt_slot& slot = slots[key & mask];
+        const uint64_t data1 = slot.data1.load(std::memory_order_relaxed);
+        const uint64_t data2 = slot.data2.load(std::memory_order_relaxed);
+        const uint64_t check = slot.check.load(std::memory_order_relaxed);
+        if ((check ^ data1 ^ data2) != key || !data2)
+            return false;
+        entry.key = key;
+        memcpy(&entry.score, &data1, sizeof(double));
+        entry.captured = uint32_t(data2);
+        entry.from = int8_t(data2 >> 32);
+        entry.to = int8_t(data2 >> 40);
+        entry.depth = int8_t(data2 >> 48);
+        entry.bound = Bound((data2 >> 56) & 3);
+        return true;
+    }
+
+    // Сохраняет результат поиска. Запись той же позиции, полученная на большей глубине, не затирается.
+    void store(const uint64_t key, const int depth, const double score, const Bound bound, const bit_move* best)
+    {
+        if (!size)
+            return;
+        tt_entry old;
+        if (probe(key, old) && old.depth > depth)
+            return;
+        uint64_t data1;
+        memcpy(&data1, &score, sizeof(double));
+        // Старший бит отмечает заполненную запись, поэтому data2 пустой ячейки равно нулю
+        const uint64_t data2 = uint64_t(best ? best->captured : 0) | (uint64_t(uint8_t(best ? best->from : -1)) << 32) |
+            (uint64_t(uint8_t(best ? best->to : -1)) << 40) | (uint64_t(uint8_t(depth)) << 48) |
+            (uint64_t(uint8_t(bound)) << 56) | (1ull << 63);
+        tt_slot& slot = slots[key & mask];
+        slot.data1.store(data1, std::memory_order_relaxed);
+        slot.data2.store(data2, std::memory_order_relaxed);
+        slot.check.store(key ^ data1 ^ data2, std::memory_order_relaxed);
+    }
+
+    // Очищает таблицу
+    void clear()
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            slots[i].check.store(0, std::memory_order_relaxed);
+            slots[i].data1.store(0, std::memory_order_relaxed);
+            slots[i].data2.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    struct tt_slot
+    {
+        std::atomic<uint64_t> check{ 0 };
+        std::atomic<uint64_t> data1{ 0 };
+        std::atomic<uint64_t> data2{ 0 };
+    };
+
+    std::unique_ptr<tt_slot[]> slots;
+    size_t size = 0;
+    uint64_t mask = 0;
+};
@@ -0,0 +1,69 @@
+#pragma once
+#include <stdint.h>
+#include <random>
+
+#include "../Models/Position.h"
+
+// Класс Zobrist хранит случайные ключи для хеширования позиций.
+// Хеш позиции - XOR ключей всех фигур на доске и ключа очереди хода, поэтому его можно
+// обновлять при каждом ходе, не пересчитывая всю доску.
+class Zobrist
+{
+public:
+    // Ключ фигуры типа type (1 - белая, 2 - чёрная, 3 - белая дамка, 4 - чёрная дамка) в клетке s
+    static uint64_t piece(const int type, const int s)
+    {
+        return keys().piece[type - 1][s];
+    }
+    // Ключ, который добавляется, если ходят чёрные
+    static uint64_t black_to_move()
+    {
+        return keys().black_to_move;
+    }
+    // Ключ, который добавляется, если бот играет за чёрных (оценки в таблице считаются с точки зрения бота)
+    static uint64_t black_bot()
+    {
+        return keys().black_bot;
+    }
+
+    // Полный хеш позиции с учётом того, чей ход
+    static uint64_t hash(const position& pos, const bool color)
+    {
+        uint64_t h = color ? black_to_move() : 0;
+        for (uint32_t pieces = pos.occupied(); pieces; pieces &= pieces - 1)
+        {
+            const int s = bit_scan(pieces);
+            h ^= piece(pos.piece(s), s);
+        }
+        return h;
+    }
+
+private:
+    struct zobrist_keys
+    {
+        uint64_t piece[4][32];
+        uint64_t black_to_move;
+        uint64_t black_bot;
+    };
+
+    // Ключи генерируются один раз с фиксированным зерном, поэтому хеши одинаковы между запусками
+    static const zobrist_keys& keys()
+    {
+        static const zobrist_keys k = make_keys();
+        return k;
+    }
+
+    static zobrist_keys make_keys()
+    {
+        zobrist_keys k;
+        std::mt19937_64 gen(0x5EED5EEDull);
+        for (int type = 0; type < 4; ++type)
+        {
+            for (int s = 0; s < 32; ++s)
+                k.piece[type][s] = gen();
+        }
+        k.black_to_move = gen();
+        k.black_bot = gen();
+        return k;
+    }
+};
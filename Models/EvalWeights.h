@@ -0,0 +1,10 @@
+#pragma once
+
+// Структура eval_weights - веса оценки материала: шашка, дамка и каждая строка продвижения шашки к дамочной
+// строке. Их использует Search::calc_score (веса Search::score_weights) и оценка пачкой BatchEval.
+struct eval_weights
+{
+    int man;
+    int king;
+    int advance;
+};
@@ -0,0 +1,17 @@
+#pragma once
+#include <stdint.h>
+
+#include "Move.h"
+
+// Структура history_record - запись журнала партии об одном шаге фигуры. Хранит всё, что нужно, чтобы
+// отменить шаг и выполнить его снова: клетки хода, побитую фигуру и превращение в дамку.
+// Клетки задаются индексами тёмных клеток (см. position::square).
+struct history_record
+{
+    int8_t from = -1;        // Откуда
+    int8_t to = -1;          // Куда
+    int8_t beaten = -1;      // Клетка побитой фигуры (-1 - ход без взятия)
+    POS_T beaten_type = 0;   // Тип побитой фигуры
+    bool promotion = false;  // Шашка стала дамкой этим шагом
+    int8_t beat_series = 0;  // Номер взятия в серии (0 - ход без взятия)
+};
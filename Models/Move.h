@@ -1,4 +1,5 @@
 #pragma once
+#include <stdint.h>
 #include <stdlib.h>
 
 typedef int8_t POS_T; // Определяем POS_T как 8-битный целочисленный тип для хранения координат
@@ -30,3 +31,31 @@ struct move_pos
         return !(*this == other);
     }
 };
+
+// Структура bit_move описывает ход в упакованной позиции (см. position): простой ход или целую серию взятий
+struct bit_move
+{
+    uint32_t captured = 0;  // Маска клеток побитых фигур
+    int8_t from = -1;       // Индекс начальной клетки
+    int8_t to = -1;         // Индекс конечной клетки
+    int8_t beats = 0;       // Количество взятий в серии (0 - ход без взятия)
+    bool promotion = false; // Шашка стала дамкой во время хода
+    int8_t path[12];        // Клетки, в которые фигура приходит после каждого взятия
+    int8_t beaten[12];      // Клетки фигур, побитых каждым взятием
+
+    bool operator==(const bit_move& other) const
+    {
+        if (from != other.from || to != other.to || beats != other.beats)
+            return false;
+        for (int i = 0; i < beats; ++i)
+        {
+            if (path[i] != other.path[i])
+                return false;
+        }
+        return true;
+    }
+    bool operator!=(const bit_move& other) const
+    {
+        return !(*this == other);
+    }
+};
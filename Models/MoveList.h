@@ -0,0 +1,84 @@
+#pragma once
+#include <stddef.h>
+#include <vector>
+
+#include "Move.h"
+
+const size_t MAX_MOVES = 256; // Вместимость списка ходов внутри структуры (в реальных позициях ходов намного меньше)
+
+// Структура move_list - список ходов. Первые MAX_MOVES ходов лежат внутри структуры, поэтому обычно
+// заполнение списка ничего не выделяет в куче. Серий взятий дамками может быть сколько угодно (каждая клетка
+// приземления после каждого взятия даёт свою серию), поэтому ходы сверх вместимости не отбрасываются:
+// список целиком переезжает в кучу.
+struct move_list
+{
+    bit_move items[MAX_MOVES + 1]; // Последний элемент - место для хода, с которого список переезжает в кучу
+    size_t count = 0;
+    std::vector<bit_move> spill; // Все ходы, если их больше MAX_MOVES, иначе пусто
+
+    void push_back(const bit_move& m)
+    {
+        if (count < MAX_MOVES)
+            items[count++] = m;
+        else
+        {
+            // Ход сначала кладётся в запасной элемент: push_back_spill не получает ход параметром,
+            // и генератору не приходится держать ход в памяти ради редкого вызова
+            items[MAX_MOVES] = m;
+            push_back_spill();
+        }
+    }
+    void clear()
+    {
+        count = 0;
+        spill.clear();
+    }
+    size_t size() const
+    {
+        return count;
+    }
+    bool empty() const
+    {
+        return count == 0;
+    }
+
+    bit_move& operator[](const size_t i)
+    {
+        return begin()[i];
+    }
+    const bit_move& operator[](const size_t i) const
+    {
+        return begin()[i];
+    }
+    const bit_move& front() const
+    {
+        return begin()[0];
+    }
+
+    bit_move* begin()
+    {
+        return spill.empty() ? items : spill.data();
+    }
+    bit_move* end()
+    {
+        return begin() + count;
+    }
+    const bit_move* begin() const
+    {
+        return spill.empty() ? items : spill.data();
+    }
+    const bit_move* end() const
+    {
+        return begin() + count;
+    }
+
+private:
+    // Переносит ход из items[MAX_MOVES] в кучу (при первом переполнении - вместе со всеми ходами списка)
+    void push_back_spill()
+    {
+        if (spill.empty())
+            spill.assign(items, items + count);
+        spill.push_back(items[MAX_MOVES]);
+        ++count;
+    }
+};
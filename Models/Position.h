@@ -0,0 +1,224 @@
+#pragma once
+#include <stdint.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include "Move.h"
+
+// Количество установленных битов в слове
+inline int bit_count(const uint32_t x)
+{
+#ifdef _MSC_VER
+    return int(__popcnt(x));
+#elif defined(__POPCNT__)
+    return __builtin_popcount(x);
+#else
+    // Без команды POPCNT (-mpopcnt) __builtin_popcount вызывает библиотечную функцию, а оценка по признакам
+    // считает биты в каждом листе поиска, поэтому биты складываются прямо в слове
+    uint32_t v = x - ((x >> 1) & 0x55555555u);
+    v = (v & 0x33333333u) + ((v >> 2) & 0x33333333u);
+    return int((((v + (v >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24);
+#endif
+}
+
+// Индекс младшего установленного бита (x != 0)
+inline int bit_scan(const uint32_t x)
+{
+#ifdef _MSC_VER
+    unsigned long idx;
+    _BitScanForward(&idx, x);
+    return int(idx);
+#else
+    return __builtin_ctz(x);
+#endif
+}
+
+// Индекс старшего установленного бита (x != 0)
+inline int bit_scan_reverse(const uint32_t x)
+{
+#ifdef _MSC_VER
+    unsigned long idx;
+    _BitScanReverse(&idx, x);
+    return int(idx);
+#else
+    return 31 - __builtin_clz(x);
+#endif
+}
+
+// Структура position хранит позицию в упакованном виде: по одному биту на каждую из 32 тёмных клеток.
+// Клетка (i, j), где (i + j) % 2 == 1, имеет индекс i * 4 + j / 2, поэтому порядок индексов
+// совпадает с порядком обхода матрицы по строкам.
+struct position
+{
+    uint32_t white = 0; // Белые шашки и дамки
+    uint32_t black = 0; // Чёрные шашки и дамки
+    uint32_t kings = 0; // Дамки обоих цветов
+    uint64_t hash = 0;  // Хеш Zobrist (вычисляется поиском, в сравнении позиций не участвует)
+    // Счётчики для оценки позиции. Поддерживаются set и MoveGen::make_move, в сравнении позиций не участвуют.
+    int8_t pieces[4] = {};   // Количество фигур каждого типа (индекс - код фигуры минус 1)
+    int16_t advance[2] = {}; // Продвижение шашек: сумма (7 - строка) для белых и сумма строк для чёрных
+
+    // Индекс клетки по её координатам
+    static int square(const POS_T i, const POS_T j)
+    {
+        return i * 4 + j / 2;
+    }
+    // Строка клетки по её индексу
+    static POS_T row(const int s)
+    {
+        return POS_T(s >> 2);
+    }
+    // Столбец клетки по её индексу
+    static POS_T col(const int s)
+    {
+        return POS_T(((s & 3) << 1) + (((s >> 2) & 1) ^ 1));
+    }
+
+    // Все занятые клетки
+    uint32_t occupied() const
+    {
+        return white | black;
+    }
+
+    // Тип фигуры в клетке с индексом s в тех же кодах, что и в матрице Board:
+    // 0 - пусто, 1 - белая, 2 - чёрная, 3 - белая дамка, 4 - чёрная дамка
+    POS_T piece(const int s) const
+    {
+        const uint32_t bit = 1u << s;
+        if (!((white | black) & bit))
+            return 0;
+        return POS_T(((white & bit) ? 1 : 2) + ((kings & bit) ? 2 : 0));
+    }
+
+    // Продвижение фигуры типа type в клетке s к строке превращения (у дамок 0)
+    static int advance_of(const int type, const int s)
+    {
+        return type == 1 ? 7 - row(s) : (type == 2 ? row(s) : 0);
+    }
+
+    // Учитывает в счётчиках появление (sign = 1) или исчезновение (sign = -1) фигуры типа type в клетке s
+    void count_piece(const int type, const int s, const int sign)
+    {
+        pieces[type - 1] += int8_t(sign);
+        if (type <= 2)
+            advance[type - 1] += int16_t(sign * advance_of(type, s));
+    }
+
+    // Тип фигуры в клетке (i, j)
+    POS_T at(const POS_T i, const POS_T j) const
+    {
+        if ((i + j) % 2 == 0)
+            return 0;
+        return piece(square(i, j));
+    }
+
+    // Ставит в клетку фигуру заданного типа (0 - очистить клетку)
+    void set(const POS_T i, const POS_T j, const POS_T type)
+    {
+        const int s = square(i, j);
+        const uint32_t bit = 1u << s;
+        if (piece(s))
+            count_piece(piece(s), s, -1);
+        white &= ~bit;
+        black &= ~bit;
+        kings &= ~bit;
+        if (!type)
+            return;
+        if (type % 2)
+            white |= bit;
+        else
+            black |= bit;
+        if (type > 2)
+            kings |= bit;
+        count_piece(type, s, 1);
+    }
+
+    // Начальная расстановка (как в Board::make_start_mtx): чёрные в строках 0-2, белые в строках 5-7
+    static position start()
+    {
+        position pos;
+        for (POS_T i = 0; i < 8; ++i)
+        {
+            for (POS_T j = (i + 1) % 2; j < 8; j += 2)
+            {
+                if (i < 3)
+                    pos.set(i, j, 2);
+                if (i > 4)
+                    pos.set(i, j, 1);
+            }
+        }
+        return pos;
+    }
+
+    // Читает позицию из строки вида "bbbbbbbbbbbb........wwwwwwwwwwww w": 32 тёмные клетки в порядке индексов
+    // ('w', 'b' - шашки, 'W', 'B' - дамки, '.' - пусто), затем через пробел, чей ход ('w' или 'b')
+    static position from_string(const std::string& str, bool& color)
+    {
+        static const std::string codes = ".wbWB";
+        if (str.size() != 34 || str[32] != ' ' || (str[33] != 'w' && str[33] != 'b'))
+            throw std::runtime_error("wrong position string: " + str);
+        position pos;
+        for (int s = 0; s < 32; ++s)
+        {
+            const size_t type = codes.find(str[s]);
+            if (type == std::string::npos)
+                throw std::runtime_error("wrong position string: " + str);
+            pos.set(row(s), col(s), POS_T(type));
+        }
+        color = str[33] == 'b';
+        return pos;
+    }
+
+    // Записывает позицию в строку того же вида, что читает from_string
+    std::string to_string(const bool color) const
+    {
+        static const char codes[] = ".wbWB";
+        std::string str(32, '.');
+        for (int s = 0; s < 32; ++s)
+            str[s] = codes[piece(s)];
+        return str + (color ? " b" : " w");
+    }
+
+    // Переводит матрицу доски 8x8 в упакованную позицию
+    static position from_matrix(const std::vector<std::vector<POS_T>>& mtx)
+    {
+        position pos;
+        for (POS_T i = 0; i < 8; ++i)
+        {
+            for (POS_T j = (i + 1) % 2; j < 8; j += 2)
+            {
+                if (mtx[i][j])
+                    pos.set(i, j, mtx[i][j]);
+            }
+        }
+        return pos;
+    }
+
+    // Переводит упакованную позицию обратно в матрицу доски 8x8
+    std::vector<std::vector<POS_T>> to_matrix() const
+    {
+        std::vector<std::vector<POS_T>> mtx(8, std::vector<POS_T>(8, 0));
+        for (POS_T i = 0; i < 8; ++i)
+        {
+            for (POS_T j = (i + 1) % 2; j < 8; j += 2)
+            {
+                mtx[i][j] = at(i, j);
+            }
+        }
+        return mtx;
+    }
+
+    bool operator==(const position& other) const
+    {
+        return white == other.white && black == other.black && kings == other.kings;
+    }
+    bool operator!=(const position& other) const
+    {
+        return !(*this == other);
+    }
+};
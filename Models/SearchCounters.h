@@ -0,0 +1,99 @@
+#pragma once
+#include <stddef.h>
+#include <algorithm>
+
+// Структура search_counters - счётчики поиска для профилирования: листья, узлы поиска взятий, обращения
+// к таблице транспозиций, отсечения по номеру хода, самая длинная серия взятий, узлы и время каждой итерации.
+// Счётчики включаются сборкой с макросом CHECKERS_STATS (например, g++ -DCHECKERS_STATS). Без него у структуры
+// нет полей, а методы пустые, поэтому компилятор убирает все вызовы и поиск не замедляется.
+struct search_counters
+{
+    static const int MAX_CUTOFF_INDEX = 8; // Отсечения на ходах с номером 7 и дальше считаются вместе
+    static const int MAX_ITERATIONS = 64;  // По записи на каждую глубину итерации (0..MAX_PLY - 1)
+
+#ifdef CHECKERS_STATS
+    static const bool enabled = true;
+
+    size_t leaves = 0;                      // Оценённые листья
+    size_t qnodes = 0;                      // Узлы поиска взятий за горизонтом
+    size_t tt_probes = 0;                   // Обращения к таблице транспозиций
+    size_t tt_hits = 0;                     // Найденные в таблице позиции
+    size_t cutoffs[MAX_CUTOFF_INDEX] = {};   // Альфа-бета отсечения по номеру хода, на котором они случились
+    int max_chain = 0;                      // Самая длинная серия взятий среди просмотренных ходов
+    int iterations = 0;                     // Количество завершённых итераций
+    size_t iteration_nodes[MAX_ITERATIONS] = {}; // Узлы с начала поиска к концу каждой итерации
+    double iteration_ms[MAX_ITERATIONS] = {};    // Время с начала поиска к концу каждой итерации
+
+    void clear()
+    {
+        *this = search_counters();
+    }
+    void leaf()
+    {
+        ++leaves;
+    }
+    void qnode()
+    {
+        ++qnodes;
+    }
+    void tt_probe(const bool hit)
+    {
+        ++tt_probes;
+        tt_hits += hit;
+    }
+    void cutoff(const size_t index)
+    {
+        ++cutoffs[std::min(index, size_t(MAX_CUTOFF_INDEX - 1))];
+    }
+    void chain(const int beats)
+    {
+        max_chain = std::max(max_chain, beats);
+    }
+    void iteration(const int depth, const size_t nodes, const double ms)
+    {
+        if (depth >= MAX_ITERATIONS)
+            return;
+        iteration_nodes[depth] = nodes;
+        iteration_ms[depth] = ms;
+        iterations = depth + 1;
+    }
+    // Добавляет счётчики другого потока поиска. Итерации у каждого потока свои, они не складываются.
+    void add(const search_counters& other)
+    {
+        leaves += other.leaves;
+        qnodes += other.qnodes;
+        tt_probes += other.tt_probes;
+        tt_hits += other.tt_hits;
+        for (int i = 0; i < MAX_CUTOFF_INDEX; ++i)
+            cutoffs[i] += other.cutoffs[i];
+        max_chain = std::max(max_chain, other.max_chain);
+    }
+#else
+    static const bool enabled = false;
+
+    void clear()
+    {
+    }
+    void leaf()
+    {
+    }
+    void qnode()
+    {
+    }
+    void tt_probe(const bool)
+    {
+    }
+    void cutoff(const size_t)
+    {
+    }
+    void chain(const int)
+    {
+    }
+    void iteration(const int, const size_t, const double)
+    {
+    }
+    void add(const search_counters&)
+    {
+    }
+#endif
+};
@@ -0,0 +1,184 @@
+// Построение дебютной книги самоигрой: бот играет сам с собой первые ходы партии (поиск на глубину level + 1),
+// и каждый сыгранный ход записывается в книгу. Партии отличаются зерном генератора, поэтому при равных оценках
+// боты выбирают разные ходы и книга получает варианты. Вес хода - сколько раз он был сыгран в этой позиции.
+//
+// Пример: BookGen --games 400 --plies 10 --level 6 --out book.bin
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "../Game/Logic.h"
+#include "../Game/MoveGen.h"
+#include "../Game/OpeningBook.h"
+#include "../Game/Zobrist.h"
+
+// Настройки построения книги
+struct book_options
+{
+    int games = 200;          // Количество партий
+    int plies = 10;           // Сколько полуходов от начала партии попадает в книгу
+    int level = 6;            // Уровень бота (глубина поиска level + 1)
+    int min_count = 2;        // Ходы, сыгранные реже, в книгу не попадают
+    int jobs = 0;             // Количество одновременно играемых партий (0 - по числу ядер)
+    unsigned seed = 1;        // Зерно генераторов (партия i использует seed + i)
+    bot_options bot;          // Настройки бота (поиск в одном потоке: параллельно играются сами партии)
+    string out_path = "book.bin";
+};
+
+// Ход в позиции: хеш позиции, клетки хода и маска побитых фигур
+typedef tuple<uint64_t, int8_t, int8_t, uint32_t> book_move;
+
+void print_usage()
+{
+    cerr << "Usage: BookGen [options]\n"
+            "  --games N              number of self-play games (200)\n"
+            "  --plies N              half-moves from the start stored in the book (10)\n"
+            "  --level L              bot level, search depth L + 1 (6)\n"
+            "  --scoring S            NumberOnly / NumberAndPotential / Features (NumberAndPotential)\n"
+            "  --time-ms T            time budget per move, 0 - no limit (0)\n"
+            "  --min-count N          drop moves played fewer times (2)\n"
+            "  --jobs N               games played at once, 0 - one per core (0)\n"
+            "  --seed N               random seed (1)\n"
+            "  --out PATH             book file (book.bin)\n";
+}
+
+book_options parse_options(const int argc, char* argv[])
+{
+    book_options options;
+    options.bot.search.scoring = Scoring::NUMBER_AND_POTENTIAL;
+    options.bot.tt_size_mb = 16;
+    for (int i = 1; i < argc; ++i)
+    {
+        const string arg = argv[i];
+        if (i + 1 >= argc)
+            throw runtime_error("missing value for " + arg);
+        const string value = argv[++i];
+        if (arg == "--games")
+            options.games = stoi(value);
+        else if (arg == "--plies")
+            options.plies = stoi(value);
+        else if (arg == "--level")
+            options.level = stoi(value);
+        else if (arg == "--scoring")
+            options.bot.search.scoring = value == "NumberOnly"
+                ? Scoring::NUMBER_ONLY
+                : (value == "Features" ? Scoring::FEATURES : Scoring::NUMBER_AND_POTENTIAL);
+        else if (arg == "--time-ms")
+            options.bot.search.time_limit_ms = stoi(value);
+        else if (arg == "--min-count")
+            options.min_count = stoi(value);
+        else if (arg == "--jobs")
+            options.jobs = stoi(value);
+        else if (arg == "--seed")
+            options.seed = unsigned(stoul(value));
+        else if (arg == "--out")
+            options.out_path = value;
+        else
+            throw runtime_error("unknown option " + arg);
+    }
+    if (options.jobs <= 0)
+        options.jobs = max(1, int(thread::hardware_concurrency()));
+    return options;
+}
+
+// Играет начало одной партии и добавляет сыгранные ходы в counts
+void play_opening(const book_options& options, const int game, map<book_move, int>& counts)
+{
+    bot_options bot = options.bot;
+    bot.seed = options.seed + unsigned(game);
+    Logic logic(bot);
+    logic.Max_depth = options.level;
+    position pos = position::start();
+    for (int ply = 0; ply < options.plies; ++ply)
+    {
+        const bool color = ply % 2;
+        const bit_move turn = logic.find_best_turn(pos, color);
+        if (turn.from == -1) // Ходов нет
+            break;
+        ++counts[book_move(Zobrist::hash(pos, color), turn.from, turn.to, turn.captured)];
+        pos = MoveGen::make_move(pos, turn, color);
+    }
+}
+
+// Записывает книгу: записи отсортированы по хешу позиции, как требует OpeningBook
+size_t write_book(const book_options& options, const map<book_move, int>& counts)
+{
+    vector<book_entry> entries;
+    for (const auto& item : counts)
+    {
+        if (item.second < options.min_count)
+            continue;
+        book_entry e;
+        e.key = get<0>(item.first);
+        e.from = get<1>(item.first);
+        e.to = get<2>(item.first);
+        e.captured = get<3>(item.first);
+        e.weight = uint16_t(min(item.second, 65535));
+        entries.push_back(e);
+    }
+    ofstream fout(options.out_path, ios::binary);
+    if (!fout)
+        throw runtime_error("cannot open " + options.out_path);
+    const uint32_t header[4] = { OpeningBook::MAGIC, OpeningBook::VERSION, uint32_t(entries.size()), 0 };
+    fout.write(reinterpret_cast<const char*>(header), sizeof(header));
+    fout.write(reinterpret_cast<const char*>(entries.data()), streamsize(entries.size() * sizeof(book_entry)));
+    if (!fout)
+        throw runtime_error("cannot write " + options.out_path);
+    return entries.size();
+}
+
+int main(int argc, char* argv[])
+{
+    book_options options;
+    try
+    {
+        options = parse_options(argc, argv);
+    }
+    catch (const exception& e)
+    {
+        cerr << e.what() << "\n";
+        print_usage();
+        return 1;
+    }
+
+    try
+    {
+        const auto start = chrono::steady_clock::now();
+        map<book_move, int> counts; // Сколько раз сыгран каждый ход (map упорядочен по хешу позиции)
+        mutex counts_mutex;
+        atomic<int> next_game(0);
+        vector<thread> jobs;
+        for (int j = 0; j < options.jobs; ++j)
+        {
+            jobs.emplace_back([&]() {
+                map<book_move, int> local;
+                for (int game = next_game++; game < options.games; game = next_game++)
+                    play_opening(options, game, local);
+                lock_guard<mutex> lock(counts_mutex);
+                for (const auto& item : local)
+                    counts[item.first] += item.second;
+            });
+        }
+        for (auto& th : jobs)
+            th.join();
+        const size_t written = write_book(options, counts);
+        const double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << counts.size() << " moves played, " << written << " written to " << options.out_path << " in "
+             << int(sec) << " s\n";
+        return 0;
+    }
+    catch (const exception& e)
+    {
+        cerr << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,162 @@
+// EvalBench: скорость оценки позиций по одной (Search::calc_score) и пачками (BatchEval::evaluate).
+// Позиции берутся из случайных партий, обе оценки сверяются на каждой позиции. Набор команд пачечной оценки
+// выбирается при сборке: -mavx2 (или /arch:AVX2) - AVX2, без него на x86-64 - SSE2, иначе обычный цикл.
+// Для сравнения печатается и скорость оценки по признакам (FeatureEval::score), у которой пачечной версии нет.
+//
+// Пример: EvalBench --positions 100000 --batch 16 --rounds 50
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../Game/BatchEval.h"
+#include "../Game/FeatureEval.h"
+#include "../Game/MoveGen.h"
+#include "../Game/Search.h"
+#include "../Models/MoveList.h"
+#include "../Models/Position.h"
+
+using namespace std;
+
+// Позиции из случайных партий от начальной расстановки (партия обрывается в случайный момент)
+vector<position> random_positions(const size_t count, const unsigned seed)
+{
+    mt19937 rand_eng(seed);
+    vector<position> res;
+    position pos = position::start();
+    bool color = false;
+    move_list turns;
+    while (res.size() < count)
+    {
+        MoveGen::generate(pos, color, turns);
+        if (turns.empty() || rand_eng() % 80 == 0)
+        {
+            pos = position::start();
+            color = false;
+            continue;
+        }
+        pos = MoveGen::make_move(pos, turns[rand_eng() % turns.size()], color);
+        color = !color;
+        res.push_back(pos);
+    }
+    return res;
+}
+
+// Оценивает все позиции rounds раз за каждый цвет бота и возвращает оценки в секунду
+template <Scoring S>
+double run(const vector<position>& boards, const size_t batch, const int rounds, const bool batched,
+    vector<double>& scores)
+{
+    const auto start = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r)
+    {
+        for (int bot_color = 0; bot_color < 2; ++bot_color)
+        {
+            for (size_t i = 0; i < boards.size(); i += batch)
+            {
+                const size_t n = min(batch, boards.size() - i);
+                if (batched)
+                    BatchEval::evaluate(&boards[i], n, bot_color != 0, Search::score_weights<S>(), INF, &scores[i]);
+                else
+                {
+                    for (size_t k = i; k < i + n; ++k)
+                        scores[k] = Search::calc_score<S>(boards[k], bot_color != 0);
+                }
+            }
+        }
+    }
+    const double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return sec > 0 ? 2.0 * rounds * boards.size() / sec : 0;
+}
+
+// Сверяет оценки пачками с оценками по одной. Возвращает количество расхождений.
+template <Scoring S> size_t compare(const vector<position>& boards, const size_t batch)
+{
+    size_t mismatches = 0;
+    vector<double> single(boards.size()), batched(boards.size());
+    for (int bot_color = 0; bot_color < 2; ++bot_color)
+    {
+        for (size_t i = 0; i < boards.size(); ++i)
+            single[i] = Search::calc_score<S>(boards[i], bot_color != 0);
+        for (size_t i = 0; i < boards.size(); i += batch)
+            BatchEval::evaluate(&boards[i], min(batch, boards.size() - i), bot_color != 0, Search::score_weights<S>(),
+                INF, &batched[i]);
+        for (size_t i = 0; i < boards.size(); ++i)
+            mismatches += single[i] != batched[i];
+    }
+    return mismatches;
+}
+
+template <Scoring S> bool bench(const char* name, const vector<position>& boards, const size_t batch, const int rounds)
+{
+    const size_t mismatches = compare<S>(boards, batch);
+    vector<double> scores(boards.size());
+    const double single = run<S>(boards, batch, rounds, false, scores);
+    const double batched = run<S>(boards, batch, rounds, true, scores);
+    cout << name << ": single " << uint64_t(single) << " evals/sec, batch " << uint64_t(batched) << " evals/sec ("
+         << (single > 0 ? batched / single : 0) << "x)";
+    if (mismatches)
+        cout << ", MISMATCH in " << mismatches << " positions";
+    cout << "\n";
+    return mismatches == 0;
+}
+
+// Оценивает все позиции по признакам rounds раз за каждый цвет бота и печатает оценки в секунду
+void bench_features(const vector<position>& boards, const int rounds)
+{
+    const FeatureEval eval; // Обученные веса по умолчанию
+    vector<double> scores(boards.size());
+    const auto start = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r)
+    {
+        for (int bot_color = 0; bot_color < 2; ++bot_color)
+        {
+            for (size_t i = 0; i < boards.size(); ++i)
+                scores[i] = eval.score(boards[i], bot_color != 0, INF);
+        }
+    }
+    const double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "Features: single " << uint64_t(sec > 0 ? 2.0 * rounds * boards.size() / sec : 0) << " evals/sec\n";
+}
+
+int main(int argc, char* argv[])
+{
+    size_t count = 100000;
+    size_t batch = 16;
+    int rounds = 50;
+    unsigned seed = 1;
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const string arg = argv[i];
+            if (arg == "--positions" && i + 1 < argc)
+                count = size_t(stoul(argv[++i]));
+            else if (arg == "--batch" && i + 1 < argc)
+                batch = size_t(stoul(argv[++i]));
+            else if (arg == "--rounds" && i + 1 < argc)
+                rounds = stoi(argv[++i]);
+            else if (arg == "--seed" && i + 1 < argc)
+                seed = unsigned(stoul(argv[++i]));
+            else
+                throw runtime_error("unknown option " + arg +
+                    " (usage: EvalBench [--positions N] [--batch N] [--rounds N] [--seed N])");
+        }
+        if (!count || !batch || rounds <= 0)
+            throw runtime_error("--positions, --batch and --rounds must be positive");
+
+        const vector<position> boards = random_positions(count, seed);
+        cout << count << " positions, batches of " << batch << ", " << BatchEval::kernel() << " kernel\n";
+        const bool ok = bench<Scoring::NUMBER_ONLY>("NumberOnly", boards, batch, rounds) &
+            bench<Scoring::NUMBER_AND_POTENTIAL>("NumberAndPotential", boards, batch, rounds);
+        bench_features(boards, rounds);
+        return ok ? 0 : 1;
+    }
+    catch (const exception& e)
+    {
+        cerr << e.what() << "\n";
+        return 1;
+    }
+}
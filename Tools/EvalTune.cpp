@@ -0,0 +1,182 @@
+// EvalTune: подбор весов метода оценки "Features" (FeatureEval) по позициям партий самоигры, как в методе Texel.
+// Сумма признаков с весами считается логарифмом шансов белых, и веса подбираются так, чтобы сигмоида от неё
+// как можно точнее предсказывала результат партии (1 - белые выиграли, 0.5 - ничья, 0 - проиграли):
+// минимизируется средний квадрат ошибки градиентным спуском (Adam) по всем позициям сразу.
+// Каждая десятая позиция в обучении не участвует: ошибка на ней показывает, не подогнаны ли веса под обучающие позиции.
+//
+// Позиции пишет SelfPlay --positions. Пример:
+// SelfPlay --games 2000 --white-level 4 --black-level 4 --positions positions.txt
+// EvalTune --in positions.txt --out weights.json
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../Game/FeatureEval.h"
+#include "../Models/Position.h"
+
+using namespace std;
+
+// Настройки подбора весов
+struct tune_options
+{
+    string in_path = "positions.txt"; // Позиции с результатами партий
+    string out_path = "weights.json"; // Файл подобранных весов
+    string start_path;                // Начальные веса (пустая строка - обученные по умолчанию)
+    int iterations = 1000;            // Количество шагов спуска
+    double rate = 0.01;               // Длина шага
+};
+
+// Позиция обучающей выборки
+struct sample
+{
+    int features[FeatureEval::COUNT]; // Признаки позиции
+    double result;                    // Результат партии для белых
+};
+
+void print_usage()
+{
+    cerr << "Usage: EvalTune [options]\n"
+            "  --in PATH              positions with game results from SelfPlay --positions (positions.txt)\n"
+            "  --out PATH             tuned weights (weights.json)\n"
+            "  --start PATH           initial weights (built-in weights)\n"
+            "  --iterations N         gradient descent steps (1000)\n"
+            "  --rate R               step size (0.01)\n";
+}
+
+tune_options parse_options(const int argc, char* argv[])
+{
+    tune_options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        const string arg = argv[i];
+        if (i + 1 >= argc)
+            throw runtime_error("missing value for " + arg);
+        const string value = argv[++i];
+        if (arg == "--in")
+            options.in_path = value;
+        else if (arg == "--out")
+            options.out_path = value;
+        else if (arg == "--start")
+            options.start_path = value;
+        else if (arg == "--iterations")
+            options.iterations = stoi(value);
+        else if (arg == "--rate")
+            options.rate = stod(value);
+        else
+            throw runtime_error("unknown option " + arg);
+    }
+    return options;
+}
+
+// Читает строки вида "<позиция> <результат>" и раскладывает их на обучающую и проверочную выборки
+void read_samples(const string& path, vector<sample>& train, vector<sample>& test)
+{
+    ifstream fin(path);
+    if (!fin)
+        throw runtime_error("cannot open " + path);
+    string line;
+    size_t count = 0;
+    while (getline(fin, line))
+    {
+        if (line.size() < 36)
+            continue;
+        bool color;
+        const position pos = position::from_string(line.substr(0, 34), color);
+        sample s;
+        FeatureEval::features(pos, s.features);
+        s.result = stod(line.substr(35));
+        (++count % 10 == 0 ? test : train).push_back(s);
+    }
+    if (train.empty())
+        throw runtime_error("no positions in " + path);
+}
+
+// Предсказанный результат партии для белых
+double predict(const FeatureEval& eval, const sample& s)
+{
+    double e = 0;
+    for (int f = 0; f < FeatureEval::COUNT; ++f)
+        e += eval.weights[f] * s.features[f];
+    return 1 / (1 + exp(-e));
+}
+
+// Средний квадрат ошибки предсказания
+double loss(const FeatureEval& eval, const vector<sample>& samples)
+{
+    double sum = 0;
+    for (const auto& s : samples)
+    {
+        const double err = predict(eval, s) - s.result;
+        sum += err * err;
+    }
+    return samples.empty() ? 0 : sum / samples.size();
+}
+
+// Шаги градиентного спуска Adam по среднему квадрату ошибки на выборке train
+void tune(FeatureEval& eval, const vector<sample>& train, const int iterations, const double rate)
+{
+    const double beta1 = 0.9, beta2 = 0.999, eps = 1e-8;
+    double m[FeatureEval::COUNT] = {}, v[FeatureEval::COUNT] = {};
+    for (int it = 1; it <= iterations; ++it)
+    {
+        double grad[FeatureEval::COUNT] = {};
+        for (const auto& s : train)
+        {
+            const double p = predict(eval, s);
+            // Производная (p - result)^2 по логарифму шансов
+            const double d = 2 * (p - s.result) * p * (1 - p);
+            for (int f = 0; f < FeatureEval::COUNT; ++f)
+                grad[f] += d * s.features[f];
+        }
+        for (int f = 0; f < FeatureEval::COUNT; ++f)
+        {
+            const double g = grad[f] / train.size();
+            m[f] = beta1 * m[f] + (1 - beta1) * g;
+            v[f] = beta2 * v[f] + (1 - beta2) * g * g;
+            const double m_hat = m[f] / (1 - pow(beta1, it)), v_hat = v[f] / (1 - pow(beta2, it));
+            eval.weights[f] -= rate * m_hat / (sqrt(v_hat) + eps);
+        }
+        if (it % 500 == 0)
+            cout << "iteration " << it << ": loss " << loss(eval, train) << "\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    tune_options options;
+    try
+    {
+        options = parse_options(argc, argv);
+    }
+    catch (const exception& e)
+    {
+        cerr << e.what() << "\n";
+        print_usage();
+        return 1;
+    }
+    try
+    {
+        vector<sample> train, test;
+        read_samples(options.in_path, train, test);
+        FeatureEval eval;
+        if (!options.start_path.empty() && !eval.load(options.start_path))
+            throw runtime_error("cannot read weights from " + options.start_path);
+        cout << train.size() << " training positions, " << test.size() << " test positions\n";
+        cout << "start: loss " << loss(eval, train) << ", test loss " << loss(eval, test) << "\n";
+        tune(eval, train, options.iterations, options.rate);
+        cout << "end: loss " << loss(eval, train) << ", test loss " << loss(eval, test) << "\n";
+        for (int f = 0; f < FeatureEval::COUNT; ++f)
+            cout << FeatureEval::name(f) << " " << eval.weights[f] << "\n";
+        if (!eval.save(options.out_path))
+            throw runtime_error("cannot write " + options.out_path);
+    }
+    catch (const exception& e)
+    {
+        cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,169 @@
+// Perft: подсчёт листьев дерева ходов до заданной глубины. Проверяет генератор ходов по сохранённым
+// эталонным числам и измеряет его скорость. Серия взятий считается одним ходом, как в поиске бота.
+//
+// Примеры:
+//   Perft                                  - прогнать набор тестовых позиций и сравнить с эталоном
+//   Perft --depth 9                        - perft начальной позиции до глубины 9
+//   Perft --position "<позиция>" --depth 6 - perft заданной позиции (формат см. position::from_string)
+//   Perft --steps                          - дополнительно сверить с генератором одиночных шагов (как ходит игрок)
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../Game/MoveGen.h"
+#include "../Models/MoveList.h"
+#include "../Models/Position.h"
+
+using namespace std;
+
+// Тестовая позиция с эталонными числами листьев для глубин 1, 2, ...
+struct perft_case
+{
+    const char* name;
+    const char* pos;
+    vector<uint64_t> nodes;
+};
+
+// Эталонные числа получены этим генератором и сверены с генератором одиночных шагов (режим --steps),
+// по которому ходит игрок.
+const vector<perft_case>& perft_cases()
+{
+    static const vector<perft_case> cases = {
+        { "start", "bbbbbbbbbbbb........wwwwwwwwwwww w",
+            { 7, 49, 302, 1469, 7482, 37986, 190146, 929984, 4571392 } },
+        // Белая шашка бьёт назад
+        { "man beats backward", ".......bb........w...b....w..... w", { 1, 4, 16, 56, 194, 544, 1370 } },
+        // Дамка бьёт серией с выбором поля приземления
+        { "queen multi-jump", "B...b.....b..........b.b.w..W... w", { 6, 45, 320, 2189, 17678, 131003, 982633 } },
+        // Шашка становится дамкой посреди серии и продолжает бить как дамка
+        { "promotion mid-series", ".....b..w..b...b.b......w....... w", { 1, 3, 13, 28, 148, 370, 2685 } },
+        // Обязательное взятие при нескольких бьющих фигурах
+        { "forced captures", "..b..b....b..bw.ww....wb...w.w.. b", { 1, 2, 7, 13, 38, 140, 422 } },
+    };
+    return cases;
+}
+
+// Число листьев на глубине depth (ходы целиком, серии взятий - один ход)
+uint64_t perft(const position& pos, const bool color, const int depth, vector<move_list>& lists)
+{
+    move_list& turns = lists[size_t(depth)];
+    MoveGen::generate(pos, color, turns);
+    if (depth == 1)
+        return turns.size();
+    uint64_t nodes = 0;
+    for (const auto& turn : turns)
+        nodes += perft(MoveGen::make_move(pos, turn, color), !color, depth - 1, lists);
+    return nodes;
+}
+
+// Выполняет одиночный шаг так же, как Board::move_piece
+position make_step(position pos, const move_pos& turn)
+{
+    const POS_T type = pos.at(turn.x, turn.y);
+    if (turn.xb != -1)
+        pos.set(turn.xb, turn.yb, 0);
+    pos.set(turn.x, turn.y, 0);
+    pos.set(turn.x2, turn.y2, ((type == 1 && turn.x2 == 0) || (type == 2 && turn.x2 == 7)) ? type + 2 : type);
+    return pos;
+}
+
+// Тот же perft по одиночным шагам (MoveGen::side_turns и piece_turns), как их выполняет Game:
+// после взятия фигура продолжает бить, пока может. Должен совпадать с perft.
+uint64_t perft_steps(const position& pos, const bool color, const int depth, const move_pos* last_beat = nullptr)
+{
+    vector<move_pos> steps;
+    if (last_beat)
+        MoveGen::piece_turns(pos, last_beat->x2, last_beat->y2, steps);
+    else
+        MoveGen::side_turns(pos, color, steps);
+    uint64_t nodes = 0;
+    for (const auto& step : steps)
+    {
+        const position next = make_step(pos, step);
+        vector<move_pos> more;
+        // Серия продолжается, если после взятия у этой фигуры снова есть взятия
+        if (step.xb != -1 && MoveGen::piece_turns(next, step.x2, step.y2, more))
+            nodes += perft_steps(next, color, depth, &step);
+        else
+            nodes += depth == 1 ? 1 : perft_steps(next, !color, depth - 1);
+    }
+    return nodes;
+}
+
+// Запускает perft с замером времени. Возвращает число листьев.
+uint64_t run(const position& pos, const bool color, const int depth, const bool steps)
+{
+    vector<move_list> lists(size_t(depth) + 1);
+    const auto start = chrono::steady_clock::now();
+    const uint64_t nodes = perft(pos, color, depth, lists);
+    const double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "  depth " << depth << ": " << nodes << " nodes, " << int(sec * 1000) << " ms, "
+         << uint64_t(sec > 0 ? nodes / sec : 0) << " nodes/sec";
+    if (steps)
+    {
+        const uint64_t step_nodes = perft_steps(pos, color, depth);
+        cout << (step_nodes == nodes ? ", steps match" : ", STEPS MISMATCH: " + to_string(step_nodes));
+        if (step_nodes != nodes)
+            throw runtime_error("step generator mismatch");
+    }
+    cout << "\n";
+    return nodes;
+}
+
+int main(int argc, char* argv[])
+{
+    string pos_str;
+    int depth = 0;
+    bool steps = false;
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const string arg = argv[i];
+            if (arg == "--steps")
+                steps = true;
+            else if (arg == "--depth" && i + 1 < argc)
+                depth = stoi(argv[++i]);
+            else if (arg == "--position" && i + 1 < argc)
+                pos_str = argv[++i];
+            else
+                throw runtime_error("unknown option " + arg);
+        }
+
+        // Одна позиция без сравнения с эталоном
+        if (depth > 0 || !pos_str.empty())
+        {
+            bool color = false;
+            const position pos = pos_str.empty() ? position::start() : position::from_string(pos_str, color);
+            for (int d = 1; d <= (depth > 0 ? depth : 6); ++d)
+                run(pos, color, d, steps);
+            return 0;
+        }
+
+        // Набор тестовых позиций
+        int failed = 0;
+        for (const auto& test : perft_cases())
+        {
+            bool color = false;
+            const position pos = position::from_string(test.pos, color);
+            cout << test.name << " (" << test.pos << ")\n";
+            for (size_t d = 0; d < test.nodes.size(); ++d)
+            {
+                if (run(pos, color, int(d) + 1, steps) != test.nodes[d])
+                {
+                    cout << "  FAILED: expected " << test.nodes[d] << "\n";
+                    ++failed;
+                }
+            }
+        }
+        cout << (failed ? "FAILED " + to_string(failed) : string("OK")) << "\n";
+        return failed ? 1 : 0;
+    }
+    catch (const exception& e)
+    {
+        cerr << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,338 @@
+// Турнир бот против бота без окна и SDL: партии играются параллельно на всех ядрах,
+// результаты пишутся в CSV и JSON.
+//
+// Пример: SelfPlay --games 200 --white-level 3 --black-level 5 --csv games.csv --moves-csv moves.csv --json summary.json
+// Позиции партий с их результатами (--positions) - обучающие данные для Tools/EvalTune.cpp.
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Game/Logic.h"
+#include "../Game/MoveGen.h"
+
+// Настройки одной стороны
+struct side_options
+{
+    int level = 3; // Уровень бота (глубина поиска level + 1)
+    bot_options bot; // Настройки бота (поиск в одном потоке: параллельно играются сами партии)
+};
+
+// Настройки турнира
+struct tournament_options
+{
+    int games = 100;       // Количество партий
+    int jobs = 0;          // Количество одновременно играемых партий (0 - по числу ядер)
+    int max_turns = 120;   // Количество ходов, после которого объявляется ничья
+    unsigned seed = 1;     // Зерно генераторов (партия i использует seed + i)
+    side_options side[2];  // Белые и чёрные
+    string csv_path;       // Результаты партий
+    string moves_csv_path; // Время каждого хода
+    string json_path;      // Итоги турнира
+    string positions_path; // Тихие позиции партий с результатом партии
+};
+
+// Один ход бота
+struct move_record
+{
+    int turn;        // Номер хода в партии
+    bool color;      // Кто ходил
+    double ms;       // Время обдумывания
+    int depth;       // Глубина последней завершённой итерации
+    size_t nodes;    // Количество просмотренных узлов
+};
+
+// Результат партии
+struct game_result
+{
+    int winner = -1; // 0 - белые, 1 - чёрные, -1 - ничья
+    int turns = 0;   // Количество сделанных ходов
+    double ms[2] = {}; // Суммарное время обдумывания белых и чёрных
+    vector<move_record> moves;
+    vector<string> positions; // Позиции перед ходом, в которых нет взятий (position::to_string)
+};
+
+// Играет одну партию. Сторона без ходов проигрывает, после max_turns ходов - ничья.
+game_result play_game(const tournament_options& options, const int game)
+{
+    // Каждой стороне свой бот со своей таблицей транспозиций на всю партию
+    vector<Logic> bots;
+    for (const auto& side : options.side)
+    {
+        bot_options bot = side.bot;
+        bot.seed = options.seed + unsigned(game);
+        bots.emplace_back(bot);
+        bots.back().Max_depth = side.level;
+    }
+    game_result res;
+    position pos = position::start();
+    move_list turns;
+    for (int turn_num = 0; turn_num < options.max_turns; ++turn_num)
+    {
+        const bool color = turn_num % 2;
+        MoveGen::generate(pos, color, turns);
+        if (turns.empty())
+        {
+            res.winner = !color;
+            break;
+        }
+        // Позиции со взятием не записываются: их оценка решается взятиями, а не признаками позиции
+        if (!options.positions_path.empty() && !MoveGen::capturers(pos, color))
+            res.positions.push_back(pos.to_string(color));
+        move_record record;
+        record.turn = turn_num;
+        record.color = color;
+        const auto start = chrono::steady_clock::now();
+        const bit_move turn = bots[color].find_best_turn(pos, color);
+        record.ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        record.depth = max(bots[color].stats.depth, 0);
+        record.nodes = bots[color].stats.nodes;
+        res.ms[color] += record.ms;
+        res.moves.push_back(record);
+        pos = MoveGen::make_move(pos, turn, color);
+        res.turns = turn_num + 1;
+    }
+    return res;
+}
+
+// Читает метод оценки по имени из settings.json
+Scoring parse_scoring(const string& name)
+{
+    if (name == "NumberOnly")
+        return Scoring::NUMBER_ONLY;
+    if (name == "NumberAndPotential")
+        return Scoring::NUMBER_AND_POTENTIAL;
+    if (name == "Features")
+        return Scoring::FEATURES;
+    throw runtime_error("unknown scoring type: " + name);
+}
+
+void print_usage()
+{
+    cerr << "Usage: SelfPlay [options]\n"
+            "  --games N              number of games (100)\n"
+            "  --jobs N               games played at once, 0 - one per core (0)\n"
+            "  --white-level L        white bot level (3)\n"
+            "  --black-level L        black bot level (3)\n"
+            "  --white-scoring S      NumberOnly / NumberAndPotential / Features (NumberAndPotential)\n"
+            "  --black-scoring S      NumberOnly / NumberAndPotential / Features (NumberAndPotential)\n"
+            "  --white-weights PATH   white weights file for Features (built-in weights)\n"
+            "  --black-weights PATH   black weights file for Features (built-in weights)\n"
+            "  --white-quiescence N   white capture search nodes per leaf, 0 - off (64)\n"
+            "  --black-quiescence N   black capture search nodes per leaf, 0 - off (64)\n"
+            "  --white-lmr 0/1        white late move reductions (1)\n"
+            "  --black-lmr 0/1        black late move reductions (1)\n"
+            "  --white-futility 0/1   white futility pruning (1)\n"
+            "  --black-futility 0/1   black futility pruning (1)\n"
+            "  --optimization O       O0 / O1 / O2 for both bots (O1)\n"
+            "  --time-ms T            time budget per move, 0 - no limit (0)\n"
+            "  --max-turns N          turns before a draw (120)\n"
+            "  --tt-mb N              transposition table size per bot (16)\n"
+            "  --tablebase PATH       endgame tablebase file for both bots (none)\n"
+            "  --book PATH            opening book file for both bots (none)\n"
+            "  --stats PATH           search counters, one JSON line per move (needs -DCHECKERS_STATS)\n"
+            "  --seed N               random seed (1)\n"
+            "  --csv PATH             per-game results\n"
+            "  --moves-csv PATH       per-move think times\n"
+            "  --json PATH            tournament summary\n"
+            "  --positions PATH       quiet positions with the game result, for EvalTune\n";
+}
+
+tournament_options parse_options(const int argc, char* argv[])
+{
+    tournament_options options;
+    for (auto& side : options.side)
+    {
+        side.bot.search.scoring = Scoring::NUMBER_AND_POTENTIAL;
+        side.bot.tt_size_mb = 16;
+    }
+    for (int i = 1; i < argc; ++i)
+    {
+        const string arg = argv[i];
+        if (i + 1 >= argc)
+            throw runtime_error("missing value for " + arg);
+        const string value = argv[++i];
+        if (arg == "--games")
+            options.games = stoi(value);
+        else if (arg == "--jobs")
+            options.jobs = stoi(value);
+        else if (arg == "--white-level")
+            options.side[0].level = stoi(value);
+        else if (arg == "--black-level")
+            options.side[1].level = stoi(value);
+        else if (arg == "--white-scoring")
+            options.side[0].bot.search.scoring = parse_scoring(value);
+        else if (arg == "--black-scoring")
+            options.side[1].bot.search.scoring = parse_scoring(value);
+        else if (arg == "--white-weights")
+            options.side[0].bot.weights_path = value;
+        else if (arg == "--black-weights")
+            options.side[1].bot.weights_path = value;
+        else if (arg == "--white-quiescence")
+            options.side[0].bot.search.quiescence_nodes = stoi(value);
+        else if (arg == "--black-quiescence")
+            options.side[1].bot.search.quiescence_nodes = stoi(value);
+        else if (arg == "--white-lmr")
+            options.side[0].bot.search.late_move_reductions = stoi(value) != 0;
+        else if (arg == "--black-lmr")
+            options.side[1].bot.search.late_move_reductions = stoi(value) != 0;
+        else if (arg == "--white-futility")
+            options.side[0].bot.search.futility_pruning = stoi(value) != 0;
+        else if (arg == "--black-futility")
+            options.side[1].bot.search.futility_pruning = stoi(value) != 0;
+        else if (arg == "--optimization")
+        {
+            for (auto& side : options.side)
+                side.bot.search.pruning = value == "O0" ? Pruning::NONE : Pruning::ALPHA_BETA;
+        }
+        else if (arg == "--time-ms")
+        {
+            for (auto& side : options.side)
+                side.bot.search.time_limit_ms = stoi(value);
+        }
+        else if (arg == "--max-turns")
+            options.max_turns = stoi(value);
+        else if (arg == "--tt-mb")
+        {
+            for (auto& side : options.side)
+                side.bot.tt_size_mb = size_t(stoul(value));
+        }
+        else if (arg == "--tablebase")
+        {
+            for (auto& side : options.side)
+                side.bot.tablebase_path = value;
+        }
+        else if (arg == "--book")
+        {
+            for (auto& side : options.side)
+                side.bot.book_path = value;
+        }
+        else if (arg == "--stats")
+        {
+            for (auto& side : options.side)
+                side.bot.stats_path = value;
+        }
+        else if (arg == "--seed")
+            options.seed = unsigned(stoul(value));
+        else if (arg == "--csv")
+            options.csv_path = value;
+        else if (arg == "--moves-csv")
+            options.moves_csv_path = value;
+        else if (arg == "--json")
+            options.json_path = value;
+        else if (arg == "--positions")
+            options.positions_path = value;
+        else
+            throw runtime_error("unknown option " + arg);
+    }
+    if (options.jobs <= 0)
+        options.jobs = max(1, int(thread::hardware_concurrency()));
+    return options;
+}
+
+void write_results(const tournament_options& options, const vector<game_result>& results, const double total_ms)
+{
+    int wins[2] = {}, draws = 0, turns = 0, moves = 0;
+    double ms = 0;
+    for (const auto& res : results)
+    {
+        if (res.winner == -1)
+            ++draws;
+        else
+            ++wins[res.winner];
+        turns += res.turns;
+        moves += int(res.moves.size());
+        ms += res.ms[0] + res.ms[1];
+    }
+
+    if (!options.csv_path.empty())
+    {
+        ofstream fout(options.csv_path);
+        fout << "game,result,turns,white_ms,black_ms\n";
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const auto& res = results[i];
+            fout << i << ',' << (res.winner == -1 ? "draw" : (res.winner ? "black" : "white")) << ',' << res.turns
+                 << ',' << res.ms[0] << ',' << res.ms[1] << '\n';
+        }
+    }
+    if (!options.moves_csv_path.empty())
+    {
+        ofstream fout(options.moves_csv_path);
+        fout << "game,turn,color,ms,depth,nodes\n";
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            for (const auto& m : results[i].moves)
+                fout << i << ',' << m.turn << ',' << (m.color ? "black" : "white") << ',' << m.ms << ',' << m.depth
+                     << ',' << m.nodes << '\n';
+        }
+    }
+
+    if (!options.positions_path.empty())
+    {
+        // Строка: позиция, затем результат партии для белых (1 - победа, 0.5 - ничья, 0 - поражение)
+        ofstream fout(options.positions_path);
+        for (const auto& res : results)
+        {
+            const char* result = res.winner == -1 ? "0.5" : (res.winner ? "0" : "1");
+            for (const auto& line : res.positions)
+                fout << line << ' ' << result << '\n';
+        }
+    }
+
+    const int games = int(results.size());
+    ostringstream summary;
+    summary << "{\n"
+            << "  \"games\": " << games << ",\n"
+            << "  \"white_level\": " << options.side[0].level << ",\n"
+            << "  \"black_level\": " << options.side[1].level << ",\n"
+            << "  \"white_wins\": " << wins[0] << ",\n"
+            << "  \"black_wins\": " << wins[1] << ",\n"
+            << "  \"draws\": " << draws << ",\n"
+            << "  \"avg_turns\": " << (games ? double(turns) / games : 0) << ",\n"
+            << "  \"avg_move_ms\": " << (moves ? ms / moves : 0) << ",\n"
+            << "  \"total_ms\": " << total_ms << "\n"
+            << "}\n";
+    if (!options.json_path.empty())
+    {
+        ofstream fout(options.json_path);
+        fout << summary.str();
+    }
+    cout << summary.str();
+}
+
+int main(int argc, char* argv[])
+{
+    tournament_options options;
+    try
+    {
+        options = parse_options(argc, argv);
+    }
+    catch (const exception& e)
+    {
+        cerr << e.what() << "\n";
+        print_usage();
+        return 1;
+    }
+
+    const auto start = chrono::steady_clock::now();
+    vector<game_result> results(size_t(max(options.games, 0)));
+    atomic<int> next_game(0);
+    vector<thread> jobs;
+    for (int j = 0; j < options.jobs; ++j)
+    {
+        jobs.emplace_back([&]() {
+            for (int game = next_game++; game < options.games; game = next_game++)
+                results[size_t(game)] = play_game(options, game);
+        });
+    }
+    for (auto& th : jobs)
+        th.join();
+    write_results(options, results, chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+    return 0;
+}
@@ -0,0 +1,250 @@
+// Построение таблиц окончаний ретроградным анализом: для всех позиций с числом фигур не больше N
+// вычисляется результат (выигрыш, проигрыш или ничья для стороны, которая ходит) и число полуходов
+// до конца партии при лучшей игре. Правила те же, что у генератора ходов: шашки бьют назад, дамки дальнобойные,
+// взятие обязательно, сторона без ходов проигрывает. Ограничение партии по числу ходов не учитывается.
+//
+// Материалы решаются от меньшего числа фигур к большему, а при равном - от меньшего числа шашек к большему,
+// поэтому позиции после взятия или превращения в дамку уже решены. Внутри материала проходы повторяются:
+// на проходе k находятся выигрыши и проигрыши ровно за k полуходов. Что не решилось, когда проходы
+// перестают что-то менять, - ничья.
+//
+// Пример: TablebaseGen --pieces 4 --out tablebase.bin
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../Game/MoveGen.h"
+#include "../Game/Tablebase.h"
+#include "../Models/MoveList.h"
+#include "../Models/Position.h"
+
+using namespace std;
+
+const int16_t UNKNOWN = -1; // Позиция ещё не решена
+
+// Материал: количество белых шашек, чёрных шашек, белых дамок и чёрных дамок
+struct material
+{
+    int wm, bm, wk, bk;
+
+    int pieces() const
+    {
+        return wm + bm + wk + bk;
+    }
+    int key() const
+    {
+        return Tablebase::material_key(wm, bm, wk, bk);
+    }
+    string name() const
+    {
+        return string(size_t(wk), 'W') + string(size_t(wm), 'w') + " vs " + string(size_t(bk), 'B') +
+            string(size_t(bm), 'b');
+    }
+};
+
+// Все материалы до max_pieces фигур в порядке решения
+vector<material> materials(const int max_pieces)
+{
+    vector<material> res;
+    for (int wm = 0; wm <= max_pieces; ++wm)
+        for (int bm = 0; bm + wm <= max_pieces; ++bm)
+            for (int wk = 0; wk + bm + wm <= max_pieces; ++wk)
+                for (int bk = 0; bk + wk + bm + wm <= max_pieces; ++bk)
+                {
+                    const material m{ wm, bm, wk, bk };
+                    if (wm + wk > 0 && bm + bk > 0 && max(max(wm, bm), max(wk, bk)) <= Tablebase::MAX_PIECES)
+                        res.push_back(m);
+                }
+    stable_sort(res.begin(), res.end(), [](const material& a, const material& b) {
+        if (a.pieces() != b.pieces())
+            return a.pieces() < b.pieces();
+        return a.wm + a.bm < b.wm + b.bm;
+    });
+    return res;
+}
+
+class Generator
+{
+public:
+    // Решает материал m. Все материалы, в которые можно попасть взятием или превращением, уже решены.
+    void solve(const material& m)
+    {
+        const int key = m.key();
+        const uint64_t size = Tablebase::material_size(key);
+        vector<int16_t> values(size, UNKNOWN); // Результат в кодировке Tablebase::encode или UNKNOWN
+        vector<uint64_t> open; // Позиции, ещё не решённые (невозможные расстановки сюда не попадают)
+        position pos;
+        bool color;
+        move_list turns;
+        for (uint64_t idx = 0; idx < size; ++idx)
+        {
+            if (!Tablebase::position_at(key, idx, pos, color))
+            {
+                values[idx] = 0;
+                continue;
+            }
+            MoveGen::generate(pos, color, turns);
+            if (turns.empty()) // Ходов нет - проигрыш
+                values[idx] = Tablebase::encode(loss(0));
+            else
+                open.push_back(idx);
+        }
+
+        // Проход k: выигрыш за k, если есть ход в проигрыш соперника за k - 1;
+        // проигрыш за k, если все ходы ведут в выигрыш соперника не дольше чем за k - 1
+        for (int k = 1; !open.empty(); ++k)
+        {
+            if (k > 127)
+                throw runtime_error("distance does not fit into a byte in " + m.name());
+            vector<uint64_t> still_open;
+            for (const uint64_t idx : open)
+            {
+                Tablebase::position_at(key, idx, pos, color);
+                MoveGen::generate(pos, color, turns);
+                bool all_win = true;
+                int min_loss = 1000, max_win = 0;
+                for (const auto& turn : turns)
+                {
+                    const position next = MoveGen::make_move(pos, turn, color);
+                    int16_t code;
+                    if (!(color ? next.white : next.black)) // Соперник остался без фигур
+                        code = Tablebase::encode(loss(0));
+                    else if (Tablebase::material_key(next) == key)
+                        code = values[Tablebase::index(next, !color)];
+                    else
+                        code = solved_value(next, !color);
+                    if (code == UNKNOWN)
+                    {
+                        all_win = false;
+                        continue;
+                    }
+                    const tb_value value = Tablebase::decode(uint8_t(code));
+                    if (value.result == TbResult::LOSS)
+                        min_loss = min(min_loss, value.distance);
+                    if (value.result == TbResult::WIN)
+                        max_win = max(max_win, value.distance);
+                    else
+                        all_win = false;
+                }
+                if (min_loss + 1 <= k)
+                    values[idx] = Tablebase::encode(win(min_loss + 1));
+                else if (all_win && max_win + 1 <= k)
+                    values[idx] = Tablebase::encode(loss(max_win + 1));
+                else
+                    still_open.push_back(idx);
+            }
+            // Результаты за k полуходов могут появиться и без изменений на этом проходе, пока k не превысило
+            // самое длинное решение в уже решённых материалах
+            if (still_open.size() == open.size() && k > max_distance)
+                break;
+            open.swap(still_open);
+        }
+
+        vector<uint8_t>& table = solved[key];
+        table.resize(size);
+        size_t wins = 0, losses = 0;
+        for (uint64_t idx = 0; idx < size; ++idx)
+        {
+            const int16_t code = values[idx] == UNKNOWN ? 0 : values[idx]; // Нерешённое - ничья
+            table[idx] = uint8_t(code);
+            if (code)
+            {
+                const tb_value value = Tablebase::decode(uint8_t(code));
+                (value.result == TbResult::WIN ? wins : losses)++;
+                max_distance = max(max_distance, value.distance);
+            }
+        }
+        cout << m.name() << ": " << size << " entries, " << wins << " wins, " << losses << " losses, "
+             << open.size() << " draws\n";
+    }
+
+    // Записывает решённые материалы в файл формата Tablebase
+    void write(const string& path, const int max_pieces) const
+    {
+        ofstream fout(path, ios::binary);
+        if (!fout)
+            throw runtime_error("cannot open " + path);
+        const uint32_t header[4] = { Tablebase::MAGIC, Tablebase::VERSION, uint32_t(max_pieces),
+            uint32_t(solved.size()) };
+        fout.write(reinterpret_cast<const char*>(header), sizeof(header));
+        uint64_t offset = sizeof(header) + solved.size() * sizeof(Tablebase::material_header);
+        for (const auto& table : solved)
+        {
+            const Tablebase::material_header m = { uint32_t(table.first), 0, offset, table.second.size() };
+            fout.write(reinterpret_cast<const char*>(&m), sizeof(m));
+            offset += table.second.size();
+        }
+        for (const auto& table : solved)
+            fout.write(reinterpret_cast<const char*>(table.second.data()), streamsize(table.second.size()));
+        if (!fout)
+            throw runtime_error("cannot write " + path);
+    }
+
+private:
+    static tb_value win(const int distance)
+    {
+        tb_value value;
+        value.result = TbResult::WIN;
+        value.distance = distance;
+        return value;
+    }
+    static tb_value loss(const int distance)
+    {
+        tb_value value;
+        value.result = TbResult::LOSS;
+        value.distance = distance;
+        return value;
+    }
+
+    // Значение позиции из уже решённого материала
+    int16_t solved_value(const position& pos, const bool color) const
+    {
+        const auto it = solved.find(Tablebase::material_key(pos));
+        if (it == solved.end())
+            throw runtime_error("material is not solved yet");
+        return it->second[Tablebase::index(pos, color)];
+    }
+
+    map<int, vector<uint8_t>> solved; // Решённые материалы по ключу
+    int max_distance = 0; // Самое длинное решение среди решённых материалов
+};
+
+int main(int argc, char* argv[])
+{
+    int max_pieces = 4;
+    string out_path = "tablebase.bin";
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const string arg = argv[i];
+            if (arg == "--pieces" && i + 1 < argc)
+                max_pieces = stoi(argv[++i]);
+            else if (arg == "--out" && i + 1 < argc)
+                out_path = argv[++i];
+            else
+                throw runtime_error("unknown option " + arg + " (usage: TablebaseGen [--pieces N] [--out PATH])");
+        }
+        if (max_pieces < 2)
+            throw runtime_error("--pieces must be at least 2");
+
+        const auto start = chrono::steady_clock::now();
+        Generator gen;
+        for (const auto& m : materials(max_pieces))
+            gen.solve(m);
+        gen.write(out_path, max_pieces);
+        const double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << "written " << out_path << " in " << int(sec) << " s\n";
+        return 0;
+    }
+    catch (const exception& e)
+    {
+        cerr << e.what() << "\n";
+        return 1;
+    }
+}